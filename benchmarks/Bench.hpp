@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+// Minimal harness for the runtime benchmarks: every case is repeated, each
+// repetition calling it for at least 2 ms; the fastest repetition gives
+// ns/element, and the hardware counters of all repetitions are divided by
+// the elements processed. Counters the kernel does not grant
+// (perf_event_paranoid, containers, VMs) come out as null.
+
+namespace bench {
+  template
+    < class T
+    >
+  inline void DoNotOptimize(T& value) {
+    asm volatile("" : "+m"(value) : : "memory");
+  }
+
+  template
+    < class T
+    >
+  inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "m"(value) : "memory");
+  }
+
+  inline constexpr std::size_t kCounters = 4;
+
+  inline constexpr std::array<const char*, kCounters> kCounterNames{
+    "cycles", "instructions", "cache_misses", "branch_misses",
+  };
+
+  // One perf_event_open descriptor per counter, so a counter that cannot be
+  // opened does not take the others with it
+  class PerfCounters {
+   public:
+    PerfCounters() {
+      constexpr std::array<std::uint64_t, kCounters> kConfigs{
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+      };
+      for (std::size_t i = 0; i < kCounters; ++i) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = kConfigs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fds_[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+      }
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+      for (int fd : fds_) {
+        if (fd >= 0) {
+          ::close(fd);
+        }
+      }
+    }
+
+    void Start() {
+      for (int fd : fds_) {
+        if (fd >= 0) {
+          ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+          ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+      }
+    }
+
+    std::array<std::optional<std::uint64_t>, kCounters> Stop() {
+      std::array<std::optional<std::uint64_t>, kCounters> values;
+      for (std::size_t i = 0; i < kCounters; ++i) {
+        std::uint64_t value;
+        if (fds_[i] >= 0 && ::ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0) == 0 &&
+            ::read(fds_[i], &value, sizeof(value)) == sizeof(value)) {
+          values[i] = value;
+        }
+      }
+      return values;
+    }
+
+   private:
+    std::array<int, kCounters> fds_;
+  };
+
+  struct Result {
+    std::string name;
+    std::size_t elements;
+    double ns_per_element;
+    std::array<std::optional<double>, kCounters> per_element;
+  };
+
+  // Command line: [--json FILE] [--filter SUBSTRING] [--repetitions N]
+  class Suite {
+   public:
+    Suite(int argc, char** argv) {
+      for (int i = 1; i + 1 < argc; i += 2) {
+        std::string_view flag = argv[i];
+        if (flag == "--json") {
+          json_path_ = argv[i + 1];
+        } else if (flag == "--filter") {
+          filter_ = argv[i + 1];
+        } else if (flag == "--repetitions") {
+          repetitions_ = std::max(1, std::atoi(argv[i + 1]));
+        }
+      }
+      std::printf("%-44s %10s %9s %9s %9s %9s\n", "benchmark", "ns/elem", "cycles", "instrs", "cmiss", "bmiss");
+    }
+
+    Suite(const Suite&) = delete;
+    Suite& operator=(const Suite&) = delete;
+
+    ~Suite() {
+      if (!json_path_.empty()) {
+        WriteJson();
+      }
+    }
+
+    // run() processes elements elements per call
+    template
+      < class F
+      >
+    void Run(std::string_view name, std::size_t elements, F&& run) {
+      if (name.find(filter_) == std::string_view::npos) {
+        return;
+      }
+      // Enough calls per repetition to dwarf the clock and counter overhead
+      std::size_t calls = 1;
+      for (double elapsed = 0; elapsed < kMinRepetitionNs && calls < (std::size_t{1} << 30); calls *= 2) {
+        elapsed = TimeCalls(run, calls);
+      }
+      double best_ns = 1e300;
+      std::array<std::uint64_t, kCounters> totals{};
+      std::array<bool, kCounters> valid;
+      valid.fill(true);
+      for (int r = 0; r < repetitions_; ++r) {
+        counters_.Start();
+        double elapsed = TimeCalls(run, calls);
+        auto counts = counters_.Stop();
+        best_ns = std::min(best_ns, elapsed);
+        for (std::size_t i = 0; i < kCounters; ++i) {
+          valid[i] = valid[i] && counts[i].has_value();
+          totals[i] += counts[i].value_or(0);
+        }
+      }
+      double per_repetition = static_cast<double>(elements) * static_cast<double>(calls);
+      Result result{std::string(name), elements, best_ns / per_repetition, {}};
+      for (std::size_t i = 0; i < kCounters; ++i) {
+        if (valid[i]) {
+          result.per_element[i] = static_cast<double>(totals[i]) / (per_repetition * repetitions_);
+        }
+      }
+      std::printf("%-44s %10.3f", result.name.c_str(), result.ns_per_element);
+      for (const auto& value : result.per_element) {
+        if (value) {
+          std::printf(" %9.3f", *value);
+        } else {
+          std::printf(" %9s", "-");
+        }
+      }
+      std::printf("\n");
+      results_.push_back(std::move(result));
+    }
+
+   private:
+    static constexpr double kMinRepetitionNs = 2e6;
+
+    template
+      < class F
+      >
+    static double TimeCalls(F& run, std::size_t calls) {
+      auto start = std::chrono::steady_clock::now();
+      for (std::size_t c = 0; c < calls; ++c) {
+        run();
+      }
+      auto stop = std::chrono::steady_clock::now();
+      return std::chrono::duration<double, std::nano>(stop - start).count();
+    }
+
+    void WriteJson() const {
+      std::FILE* out = std::fopen(json_path_.c_str(), "w");
+      if (out == nullptr) {
+        std::perror(json_path_.c_str());
+        return;
+      }
+      std::fprintf(out, "{\n  \"benchmarks\": [\n");
+      for (std::size_t r = 0; r < results_.size(); ++r) {
+        const auto& result = results_[r];
+        std::fprintf(out, "    {\"name\": \"%s\", \"elements\": %zu, \"ns_per_element\": %.6f",
+                     result.name.c_str(), result.elements, result.ns_per_element);
+        for (std::size_t i = 0; i < kCounters; ++i) {
+          if (result.per_element[i]) {
+            std::fprintf(out, ", \"%s\": %.6f", kCounterNames[i], *result.per_element[i]);
+          } else {
+            std::fprintf(out, ", \"%s\": null", kCounterNames[i]);
+          }
+        }
+        std::fprintf(out, "}%s\n", r + 1 == results_.size() ? "" : ",");
+      }
+      std::fprintf(out, "  ]\n}\n");
+      std::fclose(out);
+    }
+
+    std::string json_path_;
+    std::string filter_;
+    int repetitions_ = 15;
+    PerfCounters counters_;
+    std::vector<Result> results_;
+  };
+}
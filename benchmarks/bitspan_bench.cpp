@@ -0,0 +1,89 @@
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../task1/BitSpan.hpp"
+
+
+// BitSpan bulk operations on random bitmaps of 1M, 64M and 1G bits, against
+// the raw word loop each replaces. Reported per 64-bit word of the map.
+
+namespace {
+  std::vector<std::uint64_t> RandomWords(std::size_t words, std::uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::vector<std::uint64_t> result(words);
+    for (auto& word : result) {
+      word = random();
+    }
+    return result;
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+
+  for (std::size_t bits : {std::size_t{1} << 20, std::size_t{1} << 26, std::size_t{1} << 30}) {
+    const std::size_t words = bits / 64;
+    auto a = RandomWords(words + 1, 1);
+    auto b = RandomWords(words + 1, 2);
+    std::string size = std::to_string(bits >> 20) + "M";
+
+    BitSpan view(a.data(), bits);
+    ConstBitSpan<> other(b.data(), bits);
+    // The same number of bits, starting 13 bits into the words
+    ConstBitSpan<> shifted(b.data(), bits, 13);
+
+    suite.Run("bitspan/count/" + size, words, [&] {
+      bench::DoNotOptimize(view.Count());
+    });
+    suite.Run("bitspan/count_raw/" + size, words, [&] {
+      const std::uint64_t* x = a.data();
+      std::size_t count = 0;
+      for (std::size_t k = 0; k < words; ++k) {
+        count += static_cast<std::size_t>(std::popcount(x[k]));
+      }
+      bench::DoNotOptimize(count);
+    });
+
+    // And then Or, so the map stays random from one call to the next
+    suite.Run("bitspan/and/" + size, words, [&] {
+      view.And(other);
+      view.Or(other);
+      bench::DoNotOptimize(a.data());
+    });
+    suite.Run("bitspan/and_raw/" + size, words, [&] {
+      std::uint64_t* x = a.data();
+      const std::uint64_t* y = b.data();
+      for (std::size_t k = 0; k < words; ++k) {
+        x[k] &= y[k];
+      }
+      for (std::size_t k = 0; k < words; ++k) {
+        x[k] |= y[k];
+      }
+      bench::DoNotOptimize(a.data());
+    });
+    suite.Run("bitspan/xor_offset_13/" + size, words, [&] {
+      view.Xor(shifted);
+      bench::DoNotOptimize(a.data());
+    });
+
+    suite.Run("bitspan/rank_middle/" + size, words / 2, [&] {
+      bench::DoNotOptimize(view.Rank(bits / 2));
+    });
+    std::size_t middle = view.Count() / 2;
+    suite.Run("bitspan/select_middle/" + size, words / 2, [&] {
+      bench::DoNotOptimize(view.Select(middle));
+    });
+    // A map whose only set bit is the last one: the search reads every word
+    std::vector<std::uint64_t> empty(words);
+    empty.back() = std::uint64_t{1} << 63;
+    ConstBitSpan<> last_only(empty.data(), bits);
+    suite.Run("bitspan/find_first_set/" + size, words, [&] {
+      bench::DoNotOptimize(last_only.FindFirstSet());
+    });
+  }
+}
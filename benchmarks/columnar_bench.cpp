@@ -0,0 +1,76 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../task7/columnar.hpp"
+
+
+// ColumnarBatch against the vector of structs it replaces: appending rows,
+// warm so that neither side reallocates, and summing one column. Reported
+// per row, for a batch that fits in L2 and one that does not fit in cache.
+
+namespace {
+  struct Trade {
+    std::uint64_t id;
+    double price;
+    double quantity;
+    std::int32_t venue;
+    float fee;
+    std::uint32_t flags;
+  };
+
+  std::vector<Trade> MakeTrades(std::size_t rows) {
+    std::vector<Trade> trades(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+      trades[i] = Trade{i, 100.0 + static_cast<double>(i % 977) / 8, static_cast<double>(i % 13 + 1),
+                        static_cast<std::int32_t>(i % 7), 0.25f, static_cast<std::uint32_t>(i)};
+    }
+    return trades;
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+
+  for (std::size_t rows : {std::size_t{1} << 14, std::size_t{1} << 22}) {
+    auto trades = MakeTrades(rows);
+    std::string size = std::to_string(rows);
+
+    ColumnarBatch<Trade> batch;
+    batch.Reserve(rows);
+    std::vector<Trade> aos;
+    aos.reserve(rows);
+
+    suite.Run("columnar/append/batch/" + size, rows, [&] {
+      batch.Clear();
+      for (const auto& trade : trades) {
+        batch.Append(trade);
+      }
+      bench::DoNotOptimize(batch.Size());
+    });
+    suite.Run("columnar/append/aos_vector/" + size, rows, [&] {
+      aos.clear();
+      for (const auto& trade : trades) {
+        aos.push_back(trade);
+      }
+      bench::DoNotOptimize(aos.data());
+    });
+
+    suite.Run("columnar/scan_price/batch/" + size, rows, [&] {
+      double sum = 0;
+      for (double price : batch.Column<1>()) {
+        sum += price;
+      }
+      bench::DoNotOptimize(sum);
+    });
+    suite.Run("columnar/scan_price/aos_vector/" + size, rows, [&] {
+      double sum = 0;
+      for (const auto& trade : aos) {
+        sum += trade.price;
+      }
+      bench::DoNotOptimize(sum);
+    });
+  }
+}
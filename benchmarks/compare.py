@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""Compares benchmark JSON files against a stored baseline.
+
+    compare.py BASELINE CURRENT... [--threshold 0.10] [--write-baseline]
+
+Flags every benchmark whose ns/element grew by more than the threshold
+(relative) and exits with status 1 if there is any. Hardware counters are
+printed next to the timings when both sides have them. With
+--write-baseline the current results replace the baseline instead.
+"""
+
+import argparse
+import json
+import sys
+
+COUNTERS = ("cycles", "instructions", "cache_misses", "branch_misses")
+
+
+def load(paths):
+    results = {}
+    for path in paths:
+        with open(path) as f:
+            for entry in json.load(f)["benchmarks"]:
+                results[entry["name"]] = entry
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("current", nargs="+")
+    parser.add_argument("--threshold", type=float, default=0.10)
+    parser.add_argument("--write-baseline", action="store_true")
+    args = parser.parse_args()
+
+    current = load(args.current)
+    if args.write_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump({"benchmarks": sorted(current.values(), key=lambda e: e["name"])}, f, indent=2)
+            f.write("\n")
+        return 0
+
+    baseline = load([args.baseline])
+    regressions = 0
+    print(f"{'benchmark':44} {'base':>9} {'now':>9} {'change':>8}")
+    for name, entry in current.items():
+        if name not in baseline:
+            print(f"{name:44} {'-':>9} {entry['ns_per_element']:9.3f}      new")
+            continue
+        old = baseline[name]["ns_per_element"]
+        new = entry["ns_per_element"]
+        change = (new - old) / old if old > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        counters = []
+        for counter in COUNTERS:
+            before, after = baseline[name].get(counter), entry.get(counter)
+            if before is not None and after is not None:
+                counters.append(f"{counter} {before:.2f}->{after:.2f}")
+        print(f"{name:44} {old:9.3f} {new:9.3f} {change:+8.1%}{flag}")
+        if counters:
+            print(f"{'':44} " + ", ".join(counters))
+    for name in baseline.keys() - current.keys():
+        print(f"{name:44} {baseline[name]['ns_per_element']:9.3f} {'-':>9}  missing")
+    if regressions:
+        print(f"{regressions} regression(s) above {args.threshold:.0%}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
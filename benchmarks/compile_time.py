@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+"""Compile-time cost of the metaprogramming headers.
+
+    compile_time.py [--compilers g++ clang++] [--scales 16 64 256]
+                    [--json FILE] [--csv FILE] [--work DIR]
+
+Generates one synthetic translation unit per header and scale, compiles
+each with every compiler found and reports the wall time, the peak memory
+of the compiler process and, where the compiler exposes them, the time
+spent instantiating templates and the number of instantiations:
+
+- GCC: -ftime-report, whose "template instantiation" line gives the time;
+  GCC has no instantiation count, so that column is empty.
+- Clang: -ftime-trace, whose InstantiateClass/InstantiateFunction events
+  give both.
+
+The scale is the list length for type_lists, the enumerator count for
+EnumeratorTraits, the number of distinct FixedString arguments, and the
+field count of the Describe<T> struct (at most 256, kMaxRawFields).
+"""
+
+import argparse
+import csv
+import glob
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def type_lists_source(n):
+    types = ", ".join(f"Tag<{i}>" for i in range(n))
+    return f"""
+#include <type_traits>
+#include "type_lists.hpp"
+
+template <int I>
+struct Tag {{
+  static constexpr int Value = I;
+}};
+
+template <class T>
+using Next = Tag<T::Value + 1>;
+
+template <class T>
+struct IsEven {{
+  static constexpr bool Value = T::Value % 2 == 0;
+}};
+
+using List = type_lists::FromTuple<type_tuples::TTuple<{types}>>;
+using Mapped = type_lists::Map<Next, List>;
+using Even = type_lists::Filter<IsEven, Mapped>;
+using Back = type_lists::ToTuple<Even>;
+using Prefix = type_lists::ToTuple<type_lists::Take<{n // 2}, Mapped>>;
+static_assert(!std::is_same_v<Back, Prefix>);
+"""
+
+
+def enumerator_traits_source(n):
+    enumerators = ", ".join(f"E{i} = {i}" for i in range(n))
+    return f"""
+#include "EnumeratorTraits.hpp"
+
+enum class Big : int {{ {enumerators} }};
+
+using Traits = EnumeratorTraits<Big, {max(512, n)}>;
+static_assert(Traits::size() == {n});
+static_assert(Traits::nameAt({n - 1}) == "E{n - 1}");
+static_assert(Traits::fromName("E0") == Big::E0);
+"""
+
+
+def fixed_string_source(n):
+    uses = "\n".join(f'  + Length<"name_{i}_{"x" * (i % 17)}"_cstr>()' for i in range(n))
+    return f"""
+#include <cstddef>
+#include <string_view>
+#include "FixedString.hpp"
+
+template <FixedString<256> string>
+constexpr std::size_t Length() {{
+  return std::string_view(string).size();
+}}
+
+constexpr std::size_t kTotal = 0
+{uses};
+static_assert(kTotal > 0);
+"""
+
+
+def describe_source(n):
+    fields = "\n".join(f"  {'int' if i % 3 else 'double'} f{i};" for i in range(n))
+    return f"""
+#include <cstddef>
+#include <utility>
+#include "reflect.hpp"
+
+struct Wide {{
+{fields}
+}};
+
+using D = Describe<Wide>;
+static_assert(D::num_fields == {n});
+
+template <std::size_t... I>
+constexpr double Sum(const Wide& wide, std::index_sequence<I...>) {{
+  return (0.0 + ... + D::Get<I>(wide));
+}}
+
+double SumAll(const Wide& wide) {{
+  return Sum(wide, std::make_index_sequence<D::num_fields>());
+}}
+"""
+
+
+HEADERS = {
+    "type_lists": (type_lists_source, "task3", None),
+    "EnumeratorTraits": (enumerator_traits_source, "task6", None),
+    "FixedString": (fixed_string_source, "task4", None),
+    "Describe": (describe_source, "task7", 256),
+}
+
+
+def run_compiler(command):
+    """Runs command, returns (exit status, wall seconds, peak RSS in KiB, stderr)."""
+    start = time.perf_counter()
+    process = subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    stderr = process.stderr.read()
+    _, status, usage = os.wait4(process.pid, 0)
+    wall = time.perf_counter() - start
+    return os.waitstatus_to_exitcode(status), wall, usage.ru_maxrss, stderr
+
+
+def gcc_instantiation_time(report):
+    # " template instantiation :   usr ( %)   sys ( %)   wall ( %)   mem ( %)"
+    match = re.search(r"^\s*template instantiation\s*:(.*)$", report, re.M)
+    if not match:
+        return None
+    times = re.findall(r"([\d.]+)\s*\(\s*\d+%\)", match.group(1))
+    return float(times[2]) if len(times) >= 3 else None
+
+
+def clang_trace_stats(trace_path):
+    with open(trace_path) as f:
+        events = json.load(f)["traceEvents"]
+    instantiations = [e for e in events if e.get("name") in ("InstantiateClass", "InstantiateFunction")]
+    totals = [e for e in events if e.get("name") in ("Total InstantiateClass", "Total InstantiateFunction")]
+    seconds = sum(e.get("dur", 0) for e in totals) / 1e6
+    return len(instantiations), seconds
+
+
+def optional(value, spec):
+    return "-" if value is None else format(value, spec)
+
+
+def measure(compiler, source_path, include_dir, work):
+    is_clang = "clang" in os.path.basename(compiler)
+    command = [compiler, "-std=c++20", "-O0", "-c", source_path, "-I", include_dir,
+               "-o", os.path.join(work, "out.o")]
+    command += ["-ftime-trace", "-ftime-trace-granularity=0"] if is_clang else ["-ftime-report"]
+    status, wall, rss, stderr = run_compiler(command)
+    if status != 0:
+        sys.stderr.write(stderr)
+        return None
+    instantiations = None
+    instantiation_s = None
+    if is_clang:
+        traces = glob.glob(os.path.join(work, "out*.json"))
+        if traces:
+            instantiations, instantiation_s = clang_trace_stats(traces[0])
+            for trace in traces:
+                os.remove(trace)
+    else:
+        instantiation_s = gcc_instantiation_time(stderr)
+    return {
+        "wall_s": round(wall, 4),
+        "peak_rss_kb": rss,
+        "instantiation_s": instantiation_s,
+        "instantiations": instantiations,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--compilers", nargs="+", default=["g++", "clang++"])
+    parser.add_argument("--scales", nargs="+", type=int, default=[16, 64, 256])
+    parser.add_argument("--headers", nargs="+", default=list(HEADERS))
+    parser.add_argument("--json", default="compile_time.json")
+    parser.add_argument("--csv", default="compile_time.csv")
+    parser.add_argument("--work", help="keep the generated sources in this directory")
+    args = parser.parse_args()
+
+    compilers = [c for c in args.compilers if shutil.which(c)]
+    for missing in set(args.compilers) - set(compilers):
+        print(f"skipping {missing}: not found", file=sys.stderr)
+    if not compilers:
+        return 1
+
+    work = args.work or tempfile.mkdtemp(prefix="compile_time_")
+    os.makedirs(work, exist_ok=True)
+    rows = []
+    print(f"{'header':18} {'compiler':10} {'scale':>6} {'wall s':>8} {'peak MiB':>9} {'inst s':>8} {'insts':>7}")
+    for header in args.headers:
+        generate, directory, max_scale = HEADERS[header]
+        for scale in args.scales:
+            if max_scale is not None and scale > max_scale:
+                continue
+            source_path = os.path.join(work, f"{header}_{scale}.cpp")
+            with open(source_path, "w") as f:
+                f.write(generate(scale))
+            for compiler in compilers:
+                result = measure(compiler, source_path, os.path.join(ROOT, directory), work)
+                if result is None:
+                    print(f"{header:18} {compiler:10} {scale:6} failed", file=sys.stderr)
+                    continue
+                row = {"header": header, "compiler": compiler, "scale": scale, **result}
+                rows.append(row)
+                print(f"{header:18} {compiler:10} {scale:6} {row['wall_s']:8.3f} {row['peak_rss_kb'] / 1024:9.1f} "
+                      f"{optional(row['instantiation_s'], '.3f'):>8} {optional(row['instantiations'], 'd'):>7}")
+
+    with open(args.json, "w") as f:
+        json.dump({"results": rows}, f, indent=2)
+        f.write("\n")
+    with open(args.csv, "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=["header", "compiler", "scale", "wall_s", "peak_rss_kb",
+                                               "instantiation_s", "instantiations"])
+        writer.writeheader()
+        writer.writerows(rows)
+    if not args.work:
+        shutil.rmtree(work)
+    return 0 if rows else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
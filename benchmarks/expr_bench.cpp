@@ -0,0 +1,124 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../task2/Expr.hpp"
+
+
+// Lazy expressions of 3 to 6 operands against the code they replace, one
+// std::vector temporary per operation, and against the fused loop written
+// by hand. Operands of 4M doubles, far out of cache, so the times follow
+// the bytes moved. Reported per element of the result.
+
+namespace {
+  constexpr std::size_t kSize = std::size_t{1} << 22;
+
+  using Vector = std::vector<double>;
+
+  template
+    < class Op
+    >
+  Vector Zip(const Vector& x, const Vector& y, Op op) {
+    Vector result(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      result[i] = op(x[i], y[i]);
+    }
+    return result;
+  }
+
+  Vector operator+(const Vector& x, const Vector& y) {
+    return Zip(x, y, [](double l, double r) { return l + r; });
+  }
+
+  Vector operator-(const Vector& x, const Vector& y) {
+    return Zip(x, y, [](double l, double r) { return l - r; });
+  }
+
+  Vector operator*(const Vector& x, const Vector& y) {
+    return Zip(x, y, [](double l, double r) { return l * r; });
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+
+  std::vector<Vector> inputs;
+  for (int k = 0; k < 6; ++k) {
+    inputs.emplace_back(kSize, 1.0 + k);
+  }
+  const Vector& a = inputs[0];
+  const Vector& b = inputs[1];
+  const Vector& c = inputs[2];
+  const Vector& d = inputs[3];
+  const Vector& e = inputs[4];
+  const Vector& f = inputs[5];
+  Span<const double> sa(a.data(), kSize), sb(b.data(), kSize), sc(c.data(), kSize), sd(d.data(), kSize),
+      se(e.data(), kSize), sf(f.data(), kSize);
+  Vector out(kSize);
+  Span<double> so(out.data(), kSize);
+
+  // out = a * b + c
+  suite.Run("expr/3/lazy", kSize, [&] {
+    so = sa * sb + sc;
+    bench::DoNotOptimize(out.data());
+  });
+  suite.Run("expr/3/temporaries", kSize, [&] {
+    Vector result = a * b + c;
+    bench::DoNotOptimize(result.data());
+  });
+  suite.Run("expr/3/handwritten", kSize, [&] {
+    for (std::size_t i = 0; i < kSize; ++i) {
+      out[i] = a[i] * b[i] + c[i];
+    }
+    bench::DoNotOptimize(out.data());
+  });
+
+  // out = a * b + c * d
+  suite.Run("expr/4/lazy", kSize, [&] {
+    so = sa * sb + sc * sd;
+    bench::DoNotOptimize(out.data());
+  });
+  suite.Run("expr/4/temporaries", kSize, [&] {
+    Vector result = a * b + c * d;
+    bench::DoNotOptimize(result.data());
+  });
+  suite.Run("expr/4/handwritten", kSize, [&] {
+    for (std::size_t i = 0; i < kSize; ++i) {
+      out[i] = a[i] * b[i] + c[i] * d[i];
+    }
+    bench::DoNotOptimize(out.data());
+  });
+
+  // out = a * b + c * d - e
+  suite.Run("expr/5/lazy", kSize, [&] {
+    so = sa * sb + sc * sd - se;
+    bench::DoNotOptimize(out.data());
+  });
+  suite.Run("expr/5/temporaries", kSize, [&] {
+    Vector result = a * b + c * d - e;
+    bench::DoNotOptimize(result.data());
+  });
+  suite.Run("expr/5/handwritten", kSize, [&] {
+    for (std::size_t i = 0; i < kSize; ++i) {
+      out[i] = a[i] * b[i] + c[i] * d[i] - e[i];
+    }
+    bench::DoNotOptimize(out.data());
+  });
+
+  // out = a * b + c * d - e * f
+  suite.Run("expr/6/lazy", kSize, [&] {
+    so = sa * sb + sc * sd - se * sf;
+    bench::DoNotOptimize(out.data());
+  });
+  suite.Run("expr/6/temporaries", kSize, [&] {
+    Vector result = a * b + c * d - e * f;
+    bench::DoNotOptimize(result.data());
+  });
+  suite.Run("expr/6/handwritten", kSize, [&] {
+    for (std::size_t i = 0; i < kSize; ++i) {
+      out[i] = a[i] * b[i] + c[i] * d[i] - e[i] * f[i];
+    }
+    bench::DoNotOptimize(out.data());
+  });
+}
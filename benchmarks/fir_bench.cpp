@@ -0,0 +1,116 @@
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../task1/Span.hpp"
+#include "../task2/Slice.hpp"
+
+
+// FIR filters with 5 and 31 taps, walking the input with Windows<K>(),
+// whose windows have a static extent, against windows built with
+// Last(n).First(K) or DropFirst(i).First(K) on dynamic extents.
+
+namespace {
+  constexpr std::size_t kSamples = 1 << 16;
+
+  template
+    < class T
+    , std::size_t taps
+    >
+  struct Fir {
+    std::vector<T> input = std::vector<T>(kSamples);
+    std::vector<T> output = std::vector<T>(kSamples);
+    std::vector<T> weights = std::vector<T>(taps);
+
+    Fir() {
+      for (std::size_t i = 0; i < kSamples; ++i) {
+        input[i] = static_cast<T>(i % 97);
+      }
+      for (std::size_t k = 0; k < taps; ++k) {
+        weights[k] = static_cast<T>(k % 7 + 1);
+      }
+    }
+
+    template
+      < class Window
+      >
+    T Apply(const Window& window) const {
+      T acc = 0;
+      for (std::size_t k = 0; k < window.Size(); ++k) {
+        acc += weights[k] * window[k];
+      }
+      return acc;
+    }
+
+    void SpanWindows() {
+      Span<const T> in(input.data(), kSamples);
+      std::size_t i = 0;
+      for (auto window : in.template Windows<taps>()) {
+        output[i++] = Apply(window);
+      }
+    }
+
+    // The window size is only known at run time, as in the code these
+    // views replace
+    void SpanDynamic() {
+      Span<const T> in(input.data(), kSamples);
+      const std::size_t size = weights.size();
+      for (std::size_t i = 0; i + size <= kSamples; ++i) {
+        output[i] = Apply(in.Last(kSamples - i).First(size));
+      }
+    }
+
+    void SliceWindows() {
+      Slice<const T> in(input.data(), kSamples, 1);
+      std::size_t i = 0;
+      for (auto window : in.template Windows<taps>()) {
+        output[i++] = Apply(window);
+      }
+    }
+
+    void SliceDynamic() {
+      Slice<const T> in(input.data(), kSamples, 1);
+      const std::size_t size = weights.size();
+      for (std::size_t i = 0; i + size <= kSamples; ++i) {
+        output[i] = Apply(in.DropFirst(i).First(size));
+      }
+    }
+  };
+
+  template
+    < class T
+    , std::size_t taps
+    >
+  void FirCases(bench::Suite& suite, const char* type) {
+    Fir<T, taps> fir;
+    std::string prefix = std::string("fir/") + type + "/" + std::to_string(taps) + "_taps/";
+    constexpr std::size_t kOutputs = kSamples - taps + 1;
+    suite.Run(prefix + "span/Windows<K>", kOutputs, [&] {
+      fir.SpanWindows();
+      bench::DoNotOptimize(fir.output);
+    });
+    suite.Run(prefix + "span/Last.First(k)", kOutputs, [&] {
+      fir.SpanDynamic();
+      bench::DoNotOptimize(fir.output);
+    });
+    suite.Run(prefix + "slice/Windows<K>", kOutputs, [&] {
+      fir.SliceWindows();
+      bench::DoNotOptimize(fir.output);
+    });
+    suite.Run(prefix + "slice/DropFirst.First(k)", kOutputs, [&] {
+      fir.SliceDynamic();
+      bench::DoNotOptimize(fir.output);
+    });
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+  FirCases<float, 5>(suite, "float");
+  FirCases<float, 31>(suite, "float");
+  FirCases<std::int32_t, 5>(suite, "int32");
+  FirCases<std::int32_t, 31>(suite, "int32");
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../task7/hotcold.hpp"
+
+
+// The matching loop of an order book, price * quantity over the live side,
+// on 20-field entries of which it touches 3: HotColdStorage against a vector
+// of the whole struct, walking the rows in order and in random order.
+// Reported per row.
+
+namespace {
+  constexpr std::size_t kRows = std::size_t{1} << 21;
+
+  struct Order {
+    Annotate<Hot> _;
+    double price;
+    Annotate<Hot> __;
+    std::int32_t quantity;
+    Annotate<Hot> ___;
+    std::int32_t side;
+    std::uint64_t order_id;
+    std::uint64_t client_id;
+    std::uint64_t account;
+    std::uint64_t entered_ns;
+    std::uint64_t updated_ns;
+    std::uint64_t expires_ns;
+    std::uint64_t venue;
+    std::uint64_t session;
+    std::uint64_t strategy;
+    std::uint64_t parent_id;
+    double limit;
+    double stop;
+    double display;
+    double min_quantity;
+    double fee;
+    std::uint32_t flags;
+    std::uint32_t routing;
+  };
+
+  Order MakeOrder(std::size_t i) {
+    Order order{};
+    order.price = 100.0 + static_cast<double>(i % 977) / 8;
+    order.quantity = static_cast<std::int32_t>(i % 13 + 1);
+    order.side = static_cast<std::int32_t>(i % 2);
+    order.order_id = i;
+    return order;
+  }
+
+  template
+    < class Rows
+    , class Row
+    >
+  double MatchedNotional(const Rows& rows, const std::vector<std::uint32_t>& order, Row&& row) {
+    double notional = 0;
+    for (std::uint32_t i : order) {
+      const auto& [price, quantity, side] = row(rows, i);
+      notional += side == 1 ? price * quantity : 0;
+    }
+    return notional;
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+  std::printf("Order: %zu bytes, hot record: %zu bytes\n", sizeof(Order),
+              sizeof(HotColdStorage<Order>::HotRecord));
+
+  std::vector<Order> aos;
+  HotColdStorage<Order> split;
+  aos.reserve(kRows);
+  split.Reserve(kRows);
+  for (std::size_t i = 0; i < kRows; ++i) {
+    aos.push_back(MakeOrder(i));
+    split.PushBack(aos.back());
+  }
+
+  std::vector<std::uint32_t> sequential(kRows);
+  std::iota(sequential.begin(), sequential.end(), 0u);
+  std::vector<std::uint32_t> shuffled = sequential;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(11));
+
+  auto split_row = [](const HotColdStorage<Order>& rows, std::size_t i) {
+    return std::tie(rows.get<0>(i), rows.get<1>(i), rows.get<2>(i));
+  };
+  auto aos_row = [](const std::vector<Order>& rows, std::size_t i) {
+    return std::tie(rows[i].price, rows[i].quantity, rows[i].side);
+  };
+
+  for (const auto* order : {&sequential, &shuffled}) {
+    const char* walk = order == &sequential ? "sequential" : "random";
+    suite.Run(std::string("hotcold/match/hot_cold/") + walk, kRows, [&] {
+      bench::DoNotOptimize(MatchedNotional(split, *order, split_row));
+    });
+    suite.Run(std::string("hotcold/match/aos_vector/") + walk, kRows, [&] {
+      bench::DoNotOptimize(MatchedNotional(aos, *order, aos_row));
+    });
+  }
+}
@@ -0,0 +1,209 @@
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../task7/json.hpp"
+
+
+// ParseJson straight into a struct against a DOM parse followed by copying
+// the fields out, on market-data messages. Reported per byte of JSON, so
+// 1 / (ns/elem) is the throughput in GB/s. No DOM library is a dependency
+// of the repo, so the DOM is a minimal std::map and std::variant one; it
+// does what a DOM parser has to do, allocating a node per value and a
+// string per key, but validates as little as ParseJson does.
+
+namespace {
+  constexpr std::size_t kMessages = 2000;
+
+  struct Level {
+    Annotate<JsonName<"px"_cstr>> _;
+    double price;
+    Annotate<JsonName<"qty"_cstr>> __;
+    long quantity;
+  };
+
+  struct Message {
+    Annotate<JsonName<"sym"_cstr>> _;
+    std::string symbol;
+    Annotate<JsonName<"seq"_cstr>> __;
+    long sequence;
+    Annotate<JsonName<"ts"_cstr>> ___;
+    long timestamp;
+    Annotate<JsonName<"live"_cstr>> ____;
+    bool live;
+    Annotate<JsonName<"bid"_cstr>> _____;
+    Level bid;
+    Annotate<JsonName<"ask"_cstr>> ______;
+    Level ask;
+  };
+
+  std::vector<std::string> MakeMessages() {
+    static constexpr const char* kSymbols[] = {"AAPL", "MSFT", "ES\\u0031", "BTC-USD", "EURUSD"};
+    std::mt19937 random(5);
+    std::vector<std::string> messages;
+    for (std::size_t i = 0; i < kMessages; ++i) {
+      messages.push_back(
+          std::string(R"({"sym":")") + kSymbols[random() % 5] + R"(","seq":)" + std::to_string(i) +
+          R"(,"ts":)" + std::to_string(1700000000000000000 + random()) + R"(,"venue":{"id":"XNAS","lanes":[1,2,3]},)" +
+          R"("live":true,"bid":{"px":)" + std::to_string(100 + random() % 1000 / 100.0) + R"(,"qty":)" +
+          std::to_string(random() % 500) + R"(},"ask":{"px":)" + std::to_string(101 + random() % 1000 / 100.0) +
+          R"(,"qty":)" + std::to_string(random() % 500) + "}}");
+    }
+    return messages;
+  }
+
+  struct Node;
+  using Object = std::map<std::string, std::unique_ptr<Node>, std::less<>>;
+  using Array = std::vector<std::unique_ptr<Node>>;
+
+  struct Node {
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> value;
+  };
+
+  class DomParser {
+   public:
+    explicit DomParser(std::string_view json) : json_(json) {}
+
+    std::unique_ptr<Node> Parse() {
+      auto node = std::make_unique<Node>();
+      Skip();
+      if (pos_ == json_.size()) {
+        return nullptr;
+      }
+      char c = json_[pos_];
+      if (c == '{') {
+        ++pos_;
+        Object object;
+        Skip();
+        while (pos_ < json_.size() && json_[pos_] != '}') {
+          std::string key = String();
+          Skip();
+          ++pos_;  // ':'
+          object.emplace(std::move(key), Parse());
+          Skip();
+          if (pos_ < json_.size() && json_[pos_] == ',') {
+            ++pos_;
+            Skip();
+          }
+        }
+        ++pos_;
+        node->value = std::move(object);
+      } else if (c == '[') {
+        ++pos_;
+        Array array;
+        Skip();
+        while (pos_ < json_.size() && json_[pos_] != ']') {
+          array.push_back(Parse());
+          Skip();
+          if (pos_ < json_.size() && json_[pos_] == ',') {
+            ++pos_;
+          }
+        }
+        ++pos_;
+        node->value = std::move(array);
+      } else if (c == '"') {
+        node->value = String();
+      } else if (c == 't' || c == 'f') {
+        node->value = c == 't';
+        pos_ += c == 't' ? 4 : 5;
+      } else if (c == 'n') {
+        pos_ += 4;
+      } else {
+        double number = 0;
+        auto [ptr, ec] = std::from_chars(json_.data() + pos_, json_.data() + json_.size(), number);
+        pos_ = static_cast<std::size_t>(ptr - json_.data());
+        node->value = number;
+      }
+      return node;
+    }
+
+   private:
+    void Skip() {
+      while (pos_ < json_.size() && (json_[pos_] == ' ' || json_[pos_] == '\n')) {
+        ++pos_;
+      }
+    }
+
+    std::string String() {
+      std::size_t start = ++pos_;
+      while (pos_ < json_.size() && json_[pos_] != '"') {
+        pos_ += json_[pos_] == '\\' ? 2 : 1;
+      }
+      std::string_view raw = json_.substr(start, pos_ - start);
+      ++pos_;
+      std::string text(raw.size(), '\0');
+      if (raw.find('\\') == std::string_view::npos) {
+        text.assign(raw);
+      } else {
+        text.resize(detail::UnescapeJson(raw, text.data()).value_or(0));
+      }
+      return text;
+    }
+
+    std::string_view json_;
+    std::size_t pos_ = 0;
+  };
+
+  const Node* Member(const Node& node, std::string_view key) {
+    const auto& object = std::get<Object>(node.value);
+    auto it = object.find(key);
+    return it == object.end() ? nullptr : it->second.get();
+  }
+
+  void CopyLevel(const Node& node, Level& level) {
+    level.price = std::get<double>(Member(node, "px")->value);
+    level.quantity = static_cast<long>(std::get<double>(Member(node, "qty")->value));
+  }
+
+  void CopyMessage(const Node& node, Message& message) {
+    message.symbol = std::get<std::string>(Member(node, "sym")->value);
+    message.sequence = static_cast<long>(std::get<double>(Member(node, "seq")->value));
+    message.timestamp = static_cast<long>(std::get<double>(Member(node, "ts")->value));
+    message.live = std::get<bool>(Member(node, "live")->value);
+    CopyLevel(*Member(node, "bid"), message.bid);
+    CopyLevel(*Member(node, "ask"), message.ask);
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+
+  auto messages = MakeMessages();
+  std::size_t bytes = 0;
+  for (const auto& message : messages) {
+    bytes += message.size();
+  }
+
+  Message message{};
+  for (const auto& json : messages) {
+    if (!ParseJson(message, json)) {
+      std::fprintf(stderr, "ParseJson rejected %s\n", json.c_str());
+      return 1;
+    }
+  }
+  suite.Run("json/market_data/ParseJson", bytes, [&] {
+    long checksum = 0;
+    for (const auto& json : messages) {
+      bool parsed = ParseJson(message, json).has_value();
+      checksum += parsed ? message.bid.quantity : -1;
+    }
+    bench::DoNotOptimize(checksum);
+  });
+  suite.Run("json/market_data/dom_and_copy", bytes, [&] {
+    long checksum = 0;
+    for (const auto& json : messages) {
+      auto dom = DomParser(json).Parse();
+      CopyMessage(*dom, message);
+      checksum += message.bid.quantity;
+    }
+    bench::DoNotOptimize(checksum);
+  });
+}
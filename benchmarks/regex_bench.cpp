@@ -0,0 +1,140 @@
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../task4/Regex.hpp"
+
+
+// Search<pattern> against std::regex_search and a handwritten matcher on
+// synthetic log lines, per byte of log. The scaling cases run a search
+// that fails after reading all of a run of 'a's, whose cost per byte must
+// not grow with the length of the run.
+
+namespace {
+  constexpr std::size_t kLines = 4096;
+
+  std::vector<std::string> MakeLog() {
+    static constexpr const char* kLevels[] = {"INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR"};
+    static constexpr const char* kPaths[] = {"/api/orders", "/api/users/42", "/health", "/static/app.js"};
+    std::mt19937 random(3);
+    std::vector<std::string> lines;
+    for (std::size_t i = 0; i < kLines; ++i) {
+      std::string line = "2024-05-0" + std::to_string(random() % 9 + 1) + "T12:" + std::to_string(random() % 50 + 10) +
+                         ":07.123 " + kLevels[random() % 6] + " [worker-" + std::to_string(random() % 16) + "] GET " +
+                         kPaths[random() % 4] + " status=" + std::to_string(200 + random() % 4 * 100) +
+                         " took " + std::to_string(random() % 900) + "ms";
+      if (random() % 8 == 0) {
+        line += " id=" + std::to_string(random());
+      }
+      lines.push_back(std::move(line));
+    }
+    return lines;
+  }
+
+  std::optional<std::string_view> FindLevel(std::string_view line) {
+    std::size_t error = line.find("ERROR");
+    std::size_t warn = line.find("WARN");
+    std::size_t begin = std::min(error, warn);
+    if (begin == std::string_view::npos) {
+      return std::nullopt;
+    }
+    return line.substr(begin, begin == error ? 5 : 4);
+  }
+
+  bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+  }
+
+  std::optional<std::string_view> FindId(std::string_view line) {
+    for (std::size_t begin = line.find("id="); begin != std::string_view::npos; begin = line.find("id=", begin + 1)) {
+      std::size_t end = begin + 3;
+      while (end < line.size() && IsDigit(line[end])) {
+        ++end;
+      }
+      if (end > begin + 3) {
+        return line.substr(begin, end - begin);
+      }
+    }
+    return std::nullopt;
+  }
+
+  template
+    < class Find
+    >
+  void SearchLines(bench::Suite& suite, const std::string& name, const std::vector<std::string>& lines,
+                   std::size_t bytes, Find&& find) {
+    suite.Run(name, bytes, [&] {
+      std::size_t found = 0;
+      for (const auto& line : lines) {
+        auto match = find(line);
+        found += match ? match->size() : 0;
+      }
+      bench::DoNotOptimize(found);
+    });
+  }
+
+  std::optional<std::string_view> StdSearch(const std::regex& regex, std::string_view line) {
+    std::match_results<std::string_view::const_iterator> match;
+    if (!std::regex_search(line.begin(), line.end(), match, regex)) {
+      return std::nullopt;
+    }
+    return line.substr(static_cast<std::size_t>(match.position(0)), static_cast<std::size_t>(match.length(0)));
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+
+  auto lines = MakeLog();
+  std::size_t bytes = 0;
+  for (const auto& line : lines) {
+    bytes += line.size();
+  }
+
+  std::regex level("ERROR|WARN", std::regex::optimize);
+  SearchLines(suite, "log/level/compile_time", lines, bytes, [](std::string_view line) {
+    return Search<"ERROR|WARN"_cstr>(line);
+  });
+  SearchLines(suite, "log/level/std_regex", lines, bytes, [&](std::string_view line) {
+    return StdSearch(level, line);
+  });
+  SearchLines(suite, "log/level/handwritten", lines, bytes, FindLevel);
+
+  std::regex id("id=\\d+", std::regex::optimize);
+  SearchLines(suite, "log/id/compile_time", lines, bytes, [](std::string_view line) {
+    return Search<"id=\\d+"_cstr>(line);
+  });
+  SearchLines(suite, "log/id/std_regex", lines, bytes, [&](std::string_view line) {
+    return StdSearch(id, line);
+  });
+  SearchLines(suite, "log/id/handwritten", lines, bytes, FindId);
+
+  std::regex timestamp("\\d{4}-\\d{2}-\\d{2}T[0-9:.]+", std::regex::optimize);
+  SearchLines(suite, "log/timestamp/compile_time", lines, bytes, [](std::string_view line) {
+    return Search<"\\d{4}-\\d{2}-\\d{2}T[0-9:.]+"_cstr>(line);
+  });
+  SearchLines(suite, "log/timestamp/std_regex", lines, bytes, [&](std::string_view line) {
+    return StdSearch(timestamp, line);
+  });
+
+  std::regex request("(GET|POST) /[a-z/0-9]+ status=[45]\\d\\d", std::regex::optimize);
+  SearchLines(suite, "log/failed_request/compile_time", lines, bytes, [](std::string_view line) {
+    return Search<"(GET|POST) /[a-z/0-9]+ status=[45]\\d\\d"_cstr>(line);
+  });
+  SearchLines(suite, "log/failed_request/std_regex", lines, bytes, [&](std::string_view line) {
+    return StdSearch(request, line);
+  });
+
+  for (std::size_t size : {1 << 10, 1 << 14, 1 << 18}) {
+    std::string text(size, 'a');
+    suite.Run("scaling/a+b/" + std::to_string(size), size, [&] {
+      auto match = Search<"a+b"_cstr>(text);
+      bench::DoNotOptimize(match);
+    });
+  }
+}
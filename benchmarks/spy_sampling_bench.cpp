@@ -0,0 +1,66 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Bench.hpp"
+#include "../task5/Spy.hpp"
+
+
+// Cost of one Spy expression when 0%, 1% and 100% of expressions are
+// sampled, in both threading modes, against calling the member directly.
+// The logger does a little work, as a real one would.
+
+namespace {
+  constexpr std::size_t kExpressions = 1 << 12;
+
+  struct Accumulator {
+    std::int64_t total = 0;
+
+    void Add(std::int64_t value) {
+      total += value;
+    }
+  };
+
+  template
+    < class Threading
+    , double probability
+    >
+  void SamplingCase(bench::Suite& suite, const char* mode, const char* percent) {
+    Spy<Accumulator, Threading, SampleWithProbability<probability>> spy;
+    std::uint64_t logged = 0;
+    std::uint64_t reports = 0;
+    spy.setLogger([&](unsigned int calls) {
+      logged += calls;
+      ++reports;
+    });
+    suite.Run(std::string("spy_sampling/") + mode + "/" + percent, kExpressions, [&] {
+      for (std::size_t i = 0; i < kExpressions; ++i) {
+        spy->Add(static_cast<std::int64_t>(i));
+      }
+      bench::DoNotOptimize(logged);
+    });
+  }
+
+  template
+    < class Threading
+    >
+  void SamplingCases(bench::Suite& suite, const char* mode) {
+    SamplingCase<Threading, 0.0>(suite, mode, "0%");
+    SamplingCase<Threading, 0.01>(suite, mode, "1%");
+    SamplingCase<Threading, 1.0>(suite, mode, "100%");
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+  suite.Run("spy_sampling/baseline/plain_call", kExpressions, [&] {
+    Accumulator accumulator;
+    for (std::size_t i = 0; i < kExpressions; ++i) {
+      bench::DoNotOptimize(accumulator);
+      accumulator.Add(static_cast<std::int64_t>(i));
+    }
+    bench::DoNotOptimize(accumulator);
+  });
+  SamplingCases<SingleThreaded>(suite, "single_threaded");
+  SamplingCases<Concurrent>(suite, "concurrent");
+}
@@ -0,0 +1,92 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../task5/Spy.hpp"
+
+
+// Scalability of Spy<T, Concurrent>: 1 to 64 threads hammering one Spy,
+// against the same bookkeeping with all calls counted in one atomic.
+// Reported per expression of all threads together, so flat numbers mean
+// linear scaling.
+
+struct SingleAtomic {};
+
+namespace detail {
+  // SpyCounters<Concurrent> without the shards
+  template <>
+  struct SpyCounters<SingleAtomic> {
+    template <class Sampling>
+    void Enter(Sampling&) {
+      wrapper_cnt_.fetch_add(1, std::memory_order_relaxed);
+      calls_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <typename F>
+    void Leave(F&& on_last) {
+      if (wrapper_cnt_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        unsigned int calls = calls_.exchange(0, std::memory_order_relaxed);
+        std::lock_guard lock(log_mutex_);
+        on_last(calls);
+      }
+    }
+
+   private:
+    alignas(kCacheLine) std::atomic<unsigned int> calls_{0};
+    alignas(kCacheLine) std::atomic<unsigned int> wrapper_cnt_{0};
+    std::mutex log_mutex_;
+  };
+}
+
+namespace {
+  constexpr std::size_t kExpressionsPerThread = 1 << 14;
+
+  struct Target {
+    int id = 0;
+
+    int Id() const {
+      return id;
+    }
+  };
+
+  template
+    < class Threading
+    >
+  void Hammer(bench::Suite& suite, const char* mode, std::size_t threads) {
+    Spy<Target, Threading> spy;
+    std::atomic<unsigned long long> logged{0};
+    spy.setLogger([&logged](unsigned int calls) {
+      logged.fetch_add(calls, std::memory_order_relaxed);
+    });
+    std::string name = std::string("spy_threads/") + mode + "/" + std::to_string(threads);
+    suite.Run(name, threads * kExpressionsPerThread, [&] {
+      std::vector<std::thread> workers;
+      for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+          int sum = 0;
+          for (std::size_t i = 0; i < kExpressionsPerThread; ++i) {
+            sum += spy->Id();
+          }
+          bench::DoNotOptimize(sum);
+        });
+      }
+      for (auto& worker : workers) {
+        worker.join();
+      }
+    });
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+  std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+  for (std::size_t threads = 1; threads <= 64; threads *= 2) {
+    Hammer<Concurrent>(suite, "sharded", threads);
+    Hammer<SingleAtomic>(suite, "single_atomic", threads);
+  }
+}
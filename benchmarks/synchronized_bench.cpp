@@ -0,0 +1,105 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../task5/Synchronized.hpp"
+
+
+// Synchronized<T> read path under 1 to 64 reader threads while a writer
+// republishes the value every 100 us, against the same table behind a
+// std::shared_mutex. Reported per read of all readers together, so flat
+// numbers mean linear scaling.
+
+namespace {
+  constexpr std::size_t kReadsPerThread = 1 << 14;
+
+  struct Routes {
+    std::array<unsigned int, 256> next_hop{};
+
+    unsigned int Lookup(std::size_t key) const {
+      return next_hop[key % next_hop.size()];
+    }
+  };
+
+  // What Synchronized replaces: readers share a lock word
+  class SharedMutexRoutes {
+   public:
+    unsigned int Lookup(std::size_t key) const {
+      std::shared_lock lock(mutex_);
+      return routes_.Lookup(key);
+    }
+
+    template
+      < class F
+      >
+    void Update(F&& update) {
+      std::unique_lock lock(mutex_);
+      update(routes_);
+    }
+
+   private:
+    mutable std::shared_mutex mutex_;
+    Routes routes_;
+  };
+
+  unsigned int Lookup(const Synchronized<Routes>& routes, std::size_t key) {
+    return routes->Lookup(key);
+  }
+
+  unsigned int Lookup(const SharedMutexRoutes& routes, std::size_t key) {
+    return routes.Lookup(key);
+  }
+
+  template
+    < class Table
+    >
+  void Hammer(bench::Suite& suite, const char* mode, std::size_t readers) {
+    Table routes;
+    std::string name = std::string("synchronized_readers/") + mode + "/" + std::to_string(readers);
+    suite.Run(name, readers * kReadsPerThread, [&] {
+      std::atomic<bool> done{false};
+      std::thread writer([&] {
+        unsigned int version = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+          routes.Update([&](Routes& table) {
+            table.next_hop[version % table.next_hop.size()] = version;
+          });
+          ++version;
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+      });
+      std::vector<std::thread> workers;
+      for (std::size_t t = 0; t < readers; ++t) {
+        workers.emplace_back([&, t] {
+          unsigned int sum = 0;
+          for (std::size_t i = 0; i < kReadsPerThread; ++i) {
+            sum += Lookup(routes, i * 7 + t);
+          }
+          bench::DoNotOptimize(sum);
+        });
+      }
+      for (auto& worker : workers) {
+        worker.join();
+      }
+      done.store(true, std::memory_order_relaxed);
+      writer.join();
+    });
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+  std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+  for (std::size_t readers = 1; readers <= 64; readers *= 2) {
+    Hammer<Synchronized<Routes>>(suite, "synchronized", readers);
+    Hammer<SharedMutexRoutes>(suite, "shared_mutex", readers);
+  }
+}
@@ -0,0 +1,106 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Bench.hpp"
+#include "../task1/VectoredIO.hpp"
+
+
+// Writing a payload split into fragments to a file in the page cache:
+// copying the fragments into one buffer and calling write, WriteAll's
+// writev, and IoUring with the fragments in plain and in registered memory.
+// Reported per byte of payload, from 4 KiB to 1 MiB in 2 to 64 fragments.
+
+namespace {
+  // Rewinds fd and writes the payload, exiting on a short write
+  template
+    < class Write
+    >
+  void WriteAt0(int fd, std::size_t size, Write&& write) {
+    ::lseek(fd, 0, SEEK_SET);
+    if (write() != size) {
+      std::fprintf(stderr, "short write\n");
+      std::exit(1);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+
+  std::FILE* file = std::tmpfile();
+  if (file == nullptr) {
+    std::perror("tmpfile");
+    return 1;
+  }
+  int fd = ::fileno(file);
+
+  IoUring ring;
+  if (ring.Error() != 0) {
+    std::fprintf(stderr, "io_uring unavailable (errno %d), ring cases skipped\n", ring.Error());
+  }
+
+  constexpr std::size_t kMaxPayload = std::size_t{1} << 20;
+  std::vector<std::byte> payload(kMaxPayload);
+  for (std::size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = static_cast<std::byte>(i * 13);
+  }
+  std::vector<std::byte> registered(kMaxPayload);
+  std::memcpy(registered.data(), payload.data(), payload.size());
+  Span<std::byte> buffer(registered.data(), registered.size());
+  bool fixed = ring.Error() == 0 && ring.RegisterBuffers(Span<const Span<std::byte>>(&buffer, 1)) == 0;
+  std::vector<std::byte> scratch(kMaxPayload);
+
+  for (std::size_t size : {std::size_t{4} << 10, std::size_t{64} << 10, kMaxPayload}) {
+    for (std::size_t count : {2, 8, 64}) {
+      std::vector<Span<const std::byte>> plain;
+      std::vector<Span<const std::byte>> pinned;
+      for (std::size_t i = 0; i < count; ++i) {
+        std::size_t begin = size * i / count;
+        std::size_t end = size * (i + 1) / count;
+        plain.emplace_back(payload.data() + begin, end - begin);
+        pinned.emplace_back(registered.data() + begin, end - begin);
+      }
+      Span<const Span<const std::byte>> fragments(plain.data(), plain.size());
+      Span<const Span<const std::byte>> fixed_fragments(pinned.data(), pinned.size());
+      std::string name = std::to_string(size >> 10) + "KiB/" + std::to_string(count) + "/";
+
+      suite.Run(name + "copy_write", size, [&] {
+        WriteAt0(fd, size, [&] {
+          std::byte* out = scratch.data();
+          for (const auto& fragment : fragments) {
+            std::memcpy(out, fragment.Data(), fragment.Size());
+            out += fragment.Size();
+          }
+          Span<const std::byte> whole(scratch.data(), size);
+          return WriteAll(fd, Span<const Span<const std::byte>>(&whole, 1)).done;
+        });
+      });
+      suite.Run(name + "writev", size, [&] {
+        WriteAt0(fd, size, [&] {
+          return WriteAll(fd, fragments).done;
+        });
+      });
+      if (ring.Error() == 0) {
+        suite.Run(name + "io_uring", size, [&] {
+          WriteAt0(fd, size, [&] {
+            return ring.WriteAll(fd, fragments).done;
+          });
+        });
+      }
+      if (fixed) {
+        suite.Run(name + "io_uring_fixed", size, [&] {
+          WriteAt0(fd, size, [&] {
+            return ring.WriteAll(fd, fixed_fragments).done;
+          });
+        });
+      }
+    }
+  }
+  std::fclose(file);
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../task1/Span.hpp"
+#include "../task2/Slice.hpp"
+#include "../task5/Spy.hpp"
+
+
+// Span, Slice and Spy hot paths: iteration, random access and subview
+// creation over static and dynamic extents and strides, and the cost of one
+// Spy operator-> in each threading and sampling mode.
+
+namespace {
+  constexpr std::size_t kElements = 4096;
+  constexpr std::size_t kStrided = kElements / 4;
+  constexpr std::size_t kWindow = 8;
+
+  template
+    < class View
+    >
+  std::int64_t SumRange(const View& view) {
+    std::int64_t sum = 0;
+    for (auto value : view) {
+      sum += value;
+    }
+    return sum;
+  }
+
+  template
+    < class View
+    >
+  std::int64_t SumIndexed(const View& view, const std::vector<std::uint32_t>& order) {
+    std::int64_t sum = 0;
+    for (auto idx : order) {
+      sum += view[idx];
+    }
+    return sum;
+  }
+
+  struct Accumulator {
+    std::int64_t total = 0;
+
+    void Add(std::int64_t value) {
+      total += value;
+    }
+  };
+
+  template
+    < class Threading
+    , class Sampling
+    >
+  void SpyCase(bench::Suite& suite, const char* name) {
+    Spy<Accumulator, Threading, Sampling> spy;
+    std::int64_t logged = 0;
+    spy.setLogger([&logged](unsigned int calls) {
+      logged += calls;
+    });
+    suite.Run(name, kElements, [&] {
+      for (std::size_t i = 0; i < kElements; ++i) {
+        spy->Add(static_cast<std::int64_t>(i));
+      }
+      bench::DoNotOptimize(logged);
+    });
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Suite suite(argc, argv);
+
+  std::vector<int> data(kElements);
+  std::iota(data.begin(), data.end(), 0);
+  std::vector<std::uint32_t> order(kElements);
+  std::iota(order.begin(), order.end(), 0u);
+  std::shuffle(order.begin(), order.end(), std::mt19937(42));
+  std::vector<std::uint32_t> strided_order(order.begin(), order.begin() + kStrided);
+  for (auto& idx : strided_order) {
+    idx %= kStrided;
+  }
+
+  Span<int, kElements> span_static(data.data(), kElements);
+  Span<int> span_dynamic(data.data(), kElements);
+  Slice<int, kElements, 1> slice_static(data.data(), kElements, 1);
+  Slice<int> slice_dynamic(data.data(), kElements, 1);
+  Slice<int, kStrided, 4> slice_stride4_static(data.data(), kStrided, 4);
+  Slice<int, std::dynamic_extent, 4> slice_stride4(data.data(), kStrided, 4);
+  Slice<int, std::dynamic_extent, dynamic_stride> slice_dynamic_stride(data.data(), kStrided, 4);
+
+  auto sum = [&](const char* name, std::size_t elements, const auto& view) {
+    suite.Run(name, elements, [&] {
+      auto result = SumRange(view);
+      bench::DoNotOptimize(result);
+    });
+  };
+  sum("iterate/span/static", kElements, span_static);
+  sum("iterate/span/dynamic", kElements, span_dynamic);
+  sum("iterate/slice/static/stride1", kElements, slice_static);
+  sum("iterate/slice/dynamic/stride1", kElements, slice_dynamic);
+  sum("iterate/slice/static/stride4", kStrided, slice_stride4_static);
+  sum("iterate/slice/dynamic/stride4", kStrided, slice_stride4);
+  sum("iterate/slice/dynamic/dynamic_stride", kStrided, slice_dynamic_stride);
+
+  auto random = [&](const char* name, const auto& view, const std::vector<std::uint32_t>& indices) {
+    suite.Run(name, indices.size(), [&] {
+      auto result = SumIndexed(view, indices);
+      bench::DoNotOptimize(result);
+    });
+  };
+  random("random/span/static", span_static, order);
+  random("random/span/dynamic", span_dynamic, order);
+  random("random/slice/static/stride1", slice_static, order);
+  random("random/slice/dynamic/stride4", slice_stride4, strided_order);
+  random("random/slice/dynamic/dynamic_stride", slice_dynamic_stride, strided_order);
+
+  // One subview per position, reading through it so it is not discarded
+  constexpr std::size_t kPositions = kElements - kWindow;
+  suite.Run("subview/span/First<N>", kPositions, [&] {
+    int result = 0;
+    for (std::size_t i = 0; i < kPositions; ++i) {
+      result += span_dynamic.Last(kElements - i).First<kWindow>()[kWindow - 1];
+    }
+    bench::DoNotOptimize(result);
+  });
+  suite.Run("subview/span/First(n)", kPositions, [&] {
+    int result = 0;
+    for (std::size_t i = 0; i < kPositions; ++i) {
+      result += span_dynamic.Last(kElements - i).First(kWindow)[kWindow - 1];
+    }
+    bench::DoNotOptimize(result);
+  });
+  suite.Run("subview/span/Last<N>", kPositions, [&] {
+    int result = 0;
+    for (std::size_t i = 0; i < kPositions; ++i) {
+      result += span_dynamic.First(kElements - i).Last<kWindow>()[0];
+    }
+    bench::DoNotOptimize(result);
+  });
+  suite.Run("subview/slice/DropFirst(n)", kPositions, [&] {
+    int result = 0;
+    for (std::size_t i = 0; i < kPositions; ++i) {
+      result += slice_dynamic.DropFirst(i)[0];
+    }
+    bench::DoNotOptimize(result);
+  });
+  suite.Run("subview/slice/DropFirst.First<N>", kPositions, [&] {
+    int result = 0;
+    for (std::size_t i = 0; i < kPositions; ++i) {
+      result += slice_dynamic.DropFirst(i).First<kWindow>()[kWindow - 1];
+    }
+    bench::DoNotOptimize(result);
+  });
+  suite.Run("subview/slice/static/Skip<N>", kPositions, [&] {
+    int result = 0;
+    for (std::size_t i = 0; i < kPositions; ++i) {
+      result += slice_static.Skip<2>()[i / 2];
+    }
+    bench::DoNotOptimize(result);
+  });
+  suite.Run("subview/slice/dynamic/Skip(n)", kPositions, [&] {
+    int result = 0;
+    for (std::size_t i = 0; i < kPositions; ++i) {
+      result += slice_dynamic.Skip(2)[i / 2];
+    }
+    bench::DoNotOptimize(result);
+  });
+
+  SpyCase<SingleThreaded, AlwaysSample>(suite, "spy/single_threaded/always");
+  SpyCase<SingleThreaded, SampleWithProbability<0.0>>(suite, "spy/single_threaded/never");
+  SpyCase<Concurrent, AlwaysSample>(suite, "spy/concurrent/always");
+  SpyCase<Concurrent, SampleWithProbability<0.0>>(suite, "spy/concurrent/never");
+  suite.Run("spy/baseline/plain_call", kElements, [&] {
+    Accumulator accumulator;
+    for (std::size_t i = 0; i < kElements; ++i) {
+      bench::DoNotOptimize(accumulator);
+      accumulator.Add(static_cast<std::int64_t>(i));
+    }
+    bench::DoNotOptimize(accumulator);
+  });
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Span.hpp"
+
+
+// Monotonic allocator for scratch memory: allocation bumps a pointer inside
+// the current block, nothing is freed individually, and Reset() or a Scope
+// hands every byte back at once while keeping the blocks for reuse.
+// Blocks are 2 MiB and 2 MiB-aligned by default, the size of an x86-64 huge
+// page, so the kernel can back each one with a single TLB entry.
+// Only trivially destructible types: the arena never runs destructors.
+class Arena {
+ public:
+  static constexpr std::size_t kDefaultBlockSize = std::size_t{2} << 20;
+
+  // Position of the arena, see Rewind()
+  struct Mark {
+    std::size_t block = 0;
+    std::byte* cursor = nullptr;
+  };
+
+  // Rewinds the arena to where it was when the scope was entered, typically
+  // once per request
+  class Scope {
+   public:
+    explicit Scope(Arena& arena) : arena_(arena), mark_(arena.Position()) {}
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope() {
+      arena_.Rewind(mark_);
+    }
+
+   private:
+    Arena& arena_;
+    Mark mark_;
+  };
+
+  explicit Arena(std::size_t block_size = kDefaultBlockSize) : block_size_(block_size) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  Arena(Arena&& other) noexcept
+    : block_size_(other.block_size_),
+      blocks_(std::move(other.blocks_)),
+      current_(std::exchange(other.current_, 0)),
+      cursor_(std::exchange(other.cursor_, nullptr)),
+      end_(std::exchange(other.end_, nullptr)) {}
+
+  ~Arena() {
+    Release();
+  }
+
+  // The calling thread's arena
+  static Arena& ThreadLocal() {
+    thread_local Arena arena;
+    return arena;
+  }
+
+  void* AllocateBytes(std::size_t size, std::size_t align = alignof(std::max_align_t)) {
+    assert(align != 0 && (align & (align - 1)) == 0);
+    std::byte* start = AlignUp(cursor_, align);
+    if (cursor_ == nullptr || start > end_ || static_cast<std::size_t>(end_ - start) < size) {
+      start = Grow(size, align);
+    }
+    cursor_ = start + size;
+    return start;
+  }
+
+  // n default-initialized T: trivial types are left uninitialized
+  template
+    < class T
+    >
+  Span<T> Allocate(std::size_t n, std::size_t align = alignof(T)) {
+    static_assert(std::is_trivially_destructible_v<T>, "Arena never runs destructors");
+    assert(n <= SIZE_MAX / sizeof(T));
+    auto* data = static_cast<T*>(AllocateBytes(n * sizeof(T), std::max(align, alignof(T))));
+    std::uninitialized_default_construct_n(data, n);
+    return {data, n};
+  }
+
+  template
+    < class T
+    , std::size_t N
+    >
+  Span<T, N> Allocate() {
+    static_assert(std::is_trivially_destructible_v<T>, "Arena never runs destructors");
+    auto* data = static_cast<T*>(AllocateBytes(N * sizeof(T), alignof(T)));
+    std::uninitialized_default_construct_n(data, N);
+    return Span<T, N>{data, N};
+  }
+
+  Mark Position() const noexcept {
+    return {current_, cursor_};
+  }
+
+  // Frees everything allocated after mark was taken
+  void Rewind(Mark mark) noexcept {
+    current_ = mark.block;
+    cursor_ = mark.cursor;
+    end_ = blocks_.empty() || cursor_ == nullptr ? nullptr : blocks_[current_].data + blocks_[current_].size;
+  }
+
+  // Frees everything, keeping the blocks for the next allocations
+  void Reset() noexcept {
+    current_ = 0;
+    cursor_ = blocks_.empty() ? nullptr : blocks_[0].data;
+    end_ = blocks_.empty() ? nullptr : blocks_[0].data + blocks_[0].size;
+  }
+
+  // Frees everything and returns the blocks to the system
+  void Release() noexcept {
+    for (const auto& block : blocks_) {
+      ::operator delete(block.data, std::align_val_t{BlockAlignment(block.size)});
+    }
+    blocks_.clear();
+    current_ = 0;
+    cursor_ = nullptr;
+    end_ = nullptr;
+  }
+
+  // Bytes held in blocks, used or not
+  std::size_t Reserved() const noexcept {
+    std::size_t reserved = 0;
+    for (const auto& block : blocks_) {
+      reserved += block.size;
+    }
+    return reserved;
+  }
+
+ private:
+  struct Block {
+    std::byte* data;
+    std::size_t size;
+  };
+
+  static std::byte* AlignUp(std::byte* ptr, std::size_t align) {
+    auto address = reinterpret_cast<std::uintptr_t>(ptr);
+    return ptr + (((address + align - 1) & ~(align - 1)) - address);
+  }
+
+  std::size_t BlockAlignment(std::size_t size) const {
+    return size >= kDefaultBlockSize ? kDefaultBlockSize : alignof(std::max_align_t);
+  }
+
+  // Moves to the next retained block that fits, or allocates one; returns
+  // the aligned start of the allocation inside it
+  std::byte* Grow(std::size_t size, std::size_t align) {
+    std::size_t needed = size + align;
+    std::size_t next = cursor_ == nullptr ? current_ : current_ + 1;
+    while (next < blocks_.size() && blocks_[next].size < needed) {
+      ++next;
+    }
+    if (next == blocks_.size()) {
+      std::size_t block_size = std::max(block_size_, needed);
+      if (block_size > kDefaultBlockSize) {
+        block_size = (block_size + kDefaultBlockSize - 1) / kDefaultBlockSize * kDefaultBlockSize;
+      }
+      auto* data = static_cast<std::byte*>(::operator new(block_size, std::align_val_t{BlockAlignment(block_size)}));
+      blocks_.push_back({data, block_size});
+    }
+    current_ = next;
+    end_ = blocks_[next].data + blocks_[next].size;
+    return AlignUp(blocks_[next].data, align);
+  }
+
+  std::size_t block_size_;
+  std::vector<Block> blocks_;
+  std::size_t current_ = 0;
+  std::byte* cursor_ = nullptr;
+  std::byte* end_ = nullptr;
+};
+
+
+// Lets std::pmr containers allocate from an Arena. Deallocation is a no-op;
+// the memory comes back when the arena is reset or rewound.
+class ArenaResource : public std::pmr::memory_resource {
+ public:
+  explicit ArenaResource(Arena& arena) noexcept : arena_(&arena) {}
+
+  Arena& GetArena() const noexcept {
+    return *arena_;
+  }
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    return arena_->AllocateBytes(bytes, alignment);
+  }
+
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    const auto* resource = dynamic_cast<const ArenaResource*>(&other);
+    return resource != nullptr && resource->arena_ == arena_;
+  }
+
+  Arena* arena_;
+};
@@ -0,0 +1,410 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+#include "Span.hpp"
+
+
+// Non-owning view of extent bits packed into 64-bit words, starting at any
+// bit of the first word. Bit i of a word is (word >> i) & 1. Word is
+// std::uint64_t or const std::uint64_t; only mutable views write. Bulk
+// operations run a word at a time, funnel-shifting the other operand when
+// the two views start at different bit offsets.
+
+namespace detail {
+  inline constexpr std::size_t kWordBits = 64;
+
+  // Bits [from, to) of a word set, 0 <= from < to <= 64
+  constexpr std::uint64_t BitRange(std::size_t from, std::size_t to) {
+    std::uint64_t high = to == kWordBits ? ~std::uint64_t{0} : (std::uint64_t{1} << to) - 1;
+    return high & (~std::uint64_t{0} << from);
+  }
+
+  // Position of the k-th (0-based) set bit of word, which has more than k
+  inline std::size_t SelectInWord(std::uint64_t word, std::size_t k) {
+    for (; k != 0; --k) {
+      word &= word - 1;
+    }
+    return static_cast<std::size_t>(std::countr_zero(word));
+  }
+
+  class BitReference {
+   public:
+    constexpr BitReference(std::uint64_t* word, std::uint64_t mask) : word_(word), mask_(mask) {}
+
+    constexpr operator bool() const {
+      return (*word_ & mask_) != 0;
+    }
+
+    constexpr const BitReference& operator=(bool value) const {
+      *word_ = value ? *word_ | mask_ : *word_ & ~mask_;
+      return *this;
+    }
+
+    constexpr const BitReference& operator=(const BitReference& other) const {
+      return *this = static_cast<bool>(other);
+    }
+
+    constexpr void Flip() const {
+      *word_ ^= mask_;
+    }
+
+   private:
+    std::uint64_t* word_;
+    std::uint64_t mask_;
+  };
+}
+
+
+template
+  < std::size_t extent = std::dynamic_extent
+  , class Word = std::uint64_t
+  >
+class BitSpan : detail::SpanBase<extent> {
+  static_assert(std::same_as<std::remove_const_t<Word>, std::uint64_t>);
+
+ private:
+  using Base = detail::SpanBase<extent>;
+  using Base::Extent;
+
+  template
+    < std::size_t
+    , class
+    >
+  friend class BitSpan;
+
+ public:
+  static constexpr bool is_const = std::is_const_v<Word>;
+
+  // Proxy for one bit of a mutable view
+  using Reference = detail::BitReference;
+  using reference = std::conditional_t<is_const, bool, Reference>;
+
+  // Constructors
+
+  constexpr BitSpan() noexcept requires (extent == 0 || extent == std::dynamic_extent) = default;
+
+  // size bits starting at bit offset of words[0]
+  explicit(extent != std::dynamic_extent)
+  constexpr BitSpan(Word* words, std::size_t size, std::size_t offset = 0)
+    : Base(size), words_(words + offset / detail::kWordBits), offset_(offset % detail::kWordBits) {}
+
+  // Every bit of words
+  template
+    < std::size_t N
+    >
+  explicit(extent != std::dynamic_extent)
+  constexpr BitSpan(Span<Word, N> words) : BitSpan(words.Data(), words.Size() * detail::kWordBits) {}
+
+  template
+    < std::size_t N
+    , class W
+    >
+    requires (is_const || !std::is_const_v<W>)
+  explicit(extent != std::dynamic_extent && N == std::dynamic_extent)
+  constexpr BitSpan(const BitSpan<N, W>& other) noexcept
+    : Base(other.Size()), words_(other.words_), offset_(other.offset_) {}
+
+  constexpr BitSpan(const BitSpan& other) noexcept = default;
+
+  BitSpan& operator=(const BitSpan& other) noexcept = default;
+
+  // Element access methods
+
+  constexpr reference operator[](std::size_t idx) const {
+    assert(idx < Size());
+    std::size_t bit = offset_ + idx;
+    if constexpr (is_const) {
+      return (words_[bit / detail::kWordBits] >> (bit % detail::kWordBits)) & 1;
+    } else {
+      return Reference(words_ + bit / detail::kWordBits, std::uint64_t{1} << (bit % detail::kWordBits));
+    }
+  }
+
+  constexpr bool Test(std::size_t idx) const {
+    return static_cast<bool>((*this)[idx]);
+  }
+
+  // Word holding bit 0, and the position of bit 0 in it
+  constexpr Word* Words() const noexcept {
+    return words_;
+  }
+
+  constexpr std::size_t Offset() const noexcept {
+    return offset_;
+  }
+
+  // Observers
+
+  constexpr std::size_t Size() const noexcept {
+    return Extent();
+  }
+
+  [[nodiscard]] constexpr bool Empty() const noexcept {
+    return Size() == 0;
+  }
+
+  // Subviews
+
+  template
+    < std::size_t Count
+    >
+  constexpr BitSpan<Count, Word> First() const {
+    assert(Count <= Size());
+    return BitSpan<Count, Word>{words_, Count, offset_};
+  }
+
+  constexpr BitSpan<std::dynamic_extent, Word> First(std::size_t count) const {
+    assert(count <= Size());
+    return {words_, count, offset_};
+  }
+
+  template
+    < std::size_t Count
+    >
+  constexpr BitSpan<Count, Word> Last() const {
+    assert(Count <= Size());
+    return BitSpan<Count, Word>{words_, Count, offset_ + (Size() - Count)};
+  }
+
+  constexpr BitSpan<std::dynamic_extent, Word> Last(std::size_t count) const {
+    assert(count <= Size());
+    return {words_, count, offset_ + (Size() - count)};
+  }
+
+  // Bulk queries
+
+  // Number of set bits
+  std::size_t Count() const {
+    // Without the early exit of ForEachWord, so the interior loop vectorizes
+    const std::size_t words = WordCount();
+    if (words == 0) {
+      return 0;
+    }
+    auto count = static_cast<std::size_t>(std::popcount(words_[0] & WordMask(0, words)));
+    if (words == 1) {
+      return count;
+    }
+    const std::size_t interior_end = words - 1;
+    for (std::size_t k = 1; k < interior_end; ++k) {
+      count += static_cast<std::size_t>(std::popcount(words_[k]));
+    }
+    return count + static_cast<std::size_t>(std::popcount(words_[words - 1] & WordMask(words - 1, words)));
+  }
+
+  // Number of set bits before idx
+  std::size_t Rank(std::size_t idx) const {
+    return First(idx).Count();
+  }
+
+  // Position of the first set bit at or after from
+  std::optional<std::size_t> FindFirstSet(std::size_t from = 0) const {
+    assert(from <= Size());
+    std::optional<std::size_t> found;
+    Last(Size() - from).ForEachWord([&](std::size_t base, std::uint64_t word) {
+      if (word == 0) {
+        return true;
+      }
+      found = from + base + static_cast<std::size_t>(std::countr_zero(word));
+      return false;
+    });
+    return found;
+  }
+
+  // Position of the set bit with rank k, counting from 0
+  std::optional<std::size_t> Select(std::size_t k) const {
+    std::optional<std::size_t> found;
+    ForEachWord([&](std::size_t base, std::uint64_t word) {
+      auto count = static_cast<std::size_t>(std::popcount(word));
+      if (k >= count) {
+        k -= count;
+        return true;
+      }
+      found = base + detail::SelectInWord(word, k);
+      return false;
+    });
+    return found;
+  }
+
+  // Bulk modification, with another view of the same size
+
+  void Fill(bool value) const requires (!is_const) {
+    Combine(*this, [value](std::uint64_t, std::uint64_t) {
+      return value ? ~std::uint64_t{0} : std::uint64_t{0};
+    });
+  }
+
+  template
+    < std::size_t N
+    , class W
+    >
+  void CopyFrom(const BitSpan<N, W>& other) const requires (!is_const) {
+    Combine(other, [](std::uint64_t, std::uint64_t b) { return b; });
+  }
+
+  template
+    < std::size_t N
+    , class W
+    >
+  void And(const BitSpan<N, W>& other) const requires (!is_const) {
+    Combine(other, [](std::uint64_t a, std::uint64_t b) { return a & b; });
+  }
+
+  template
+    < std::size_t N
+    , class W
+    >
+  void Or(const BitSpan<N, W>& other) const requires (!is_const) {
+    Combine(other, [](std::uint64_t a, std::uint64_t b) { return a | b; });
+  }
+
+  template
+    < std::size_t N
+    , class W
+    >
+  void Xor(const BitSpan<N, W>& other) const requires (!is_const) {
+    Combine(other, [](std::uint64_t a, std::uint64_t b) { return a ^ b; });
+  }
+
+  // Clears the bits set in other
+  template
+    < std::size_t N
+    , class W
+    >
+  void AndNot(const BitSpan<N, W>& other) const requires (!is_const) {
+    Combine(other, [](std::uint64_t a, std::uint64_t b) { return a & ~b; });
+  }
+
+ private:
+  constexpr std::size_t WordCount() const {
+    return (offset_ + Size() + detail::kWordBits - 1) / detail::kWordBits;
+  }
+
+  // Bits of word k that belong to the view
+  constexpr std::uint64_t WordMask(std::size_t k, std::size_t words) const {
+    std::size_t from = k == 0 ? offset_ : 0;
+    std::size_t to = k + 1 == words ? offset_ + Size() - k * detail::kWordBits : detail::kWordBits;
+    return detail::BitRange(from, to);
+  }
+
+  // Calls visit(position of bit 0 of word, word) with the bits of the view
+  // shifted down to bit 0 and the rest cleared, until visit returns false
+  template
+    < class Visit
+    >
+  void ForEachWord(Visit visit) const {
+    const std::size_t words = WordCount();
+    if (words == 0) {
+      return;
+    }
+    // The first word is shifted to bit 0, the others are not, so positions
+    // of their bits are k * 64 - offset_
+    if (!visit(0, (words_[0] & WordMask(0, words)) >> offset_) || words == 1) {
+      return;
+    }
+    for (std::size_t k = 1; k + 1 < words; ++k) {
+      if (!visit(k * detail::kWordBits - offset_, words_[k])) {
+        return;
+      }
+    }
+    std::size_t last = words - 1;
+    visit(last * detail::kWordBits - offset_, words_[last] & WordMask(last, words));
+  }
+
+  // Bits [bit, bit + 64) of words, reading zeros outside the words
+  // [0, count) that exist
+  static std::uint64_t FetchClipped(const std::uint64_t* words, std::size_t count, std::ptrdiff_t bit) {
+    std::ptrdiff_t index = bit >= 0 ? bit / 64 : -((63 - bit) / 64);
+    auto shift = static_cast<unsigned>(bit - index * 64);
+    auto load = [&](std::ptrdiff_t i) {
+      return i >= 0 && static_cast<std::size_t>(i) < count ? words[i] : std::uint64_t{0};
+    };
+    std::uint64_t low = load(index);
+    return shift == 0 ? low : (low >> shift) | (load(index + 1) << (64 - shift));
+  }
+
+  // words_[k] = op(words_[k], the matching 64 bits of other) for every word
+  // of the view, leaving bits outside it as they were. other may be the
+  // view itself but must not overlap it otherwise
+  template
+    < std::size_t N
+    , class W
+    , class Op
+    >
+  void Combine(const BitSpan<N, W>& other, Op op) const {
+    assert(other.Size() == Size());
+    const std::size_t words = WordCount();
+    if (words == 0) {
+      return;
+    }
+    const std::uint64_t* source = other.words_;
+    const std::size_t source_words = other.WordCount();
+    const std::ptrdiff_t shift = static_cast<std::ptrdiff_t>(other.offset_) - static_cast<std::ptrdiff_t>(offset_);
+    auto edge = [&](std::size_t k) {
+      std::uint64_t mask = WordMask(k, words);
+      std::uint64_t value = FetchClipped(source, source_words, static_cast<std::ptrdiff_t>(k * 64) + shift);
+      words_[k] = (words_[k] & ~mask) | (op(words_[k], value) & mask);
+    };
+    if (words == 1) {
+      edge(0);
+      return;
+    }
+    // Edge words that the view covers completely join the interior loop,
+    // which then starts on the caller's word alignment. Interior words lie
+    // wholly inside both views, so every source word read below exists
+    const std::size_t begin = offset_ == 0 ? 0 : 1;
+    const std::size_t end = (offset_ + Size()) % detail::kWordBits == 0 ? words : words - 1;
+    if (begin == 1) {
+      edge(0);
+    }
+    Word* out = words_;
+    if (shift == 0) {
+      for (std::size_t k = begin; k < end; ++k) {
+        out[k] = op(out[k], source[k]);
+      }
+    } else if (shift > 0) {
+      auto low = static_cast<unsigned>(shift);
+      for (std::size_t k = begin; k < end; ++k) {
+        out[k] = op(out[k], (source[k] >> low) | (source[k + 1] << (64 - low)));
+      }
+    } else {
+      // offset_ > 0 here, so begin == 1
+      auto low = static_cast<unsigned>(shift + 64);
+      for (std::size_t k = begin; k < end; ++k) {
+        out[k] = op(out[k], (source[k - 1] >> low) | (source[k] << (64 - low)));
+      }
+    }
+    if (end != words) {
+      edge(words - 1);
+    }
+  }
+
+  Word* words_ = nullptr;
+  std::size_t offset_ = 0;
+};
+
+
+template
+  < std::size_t extent = std::dynamic_extent
+  >
+using ConstBitSpan = BitSpan<extent, const std::uint64_t>;
+
+
+// Deduction guides
+
+template
+  < class Word
+  , std::size_t N
+  >
+BitSpan(Span<Word, N>) -> BitSpan<std::dynamic_extent, Word>;
+
+template
+  < class Word
+  >
+BitSpan(Word*, std::size_t, std::size_t = 0) -> BitSpan<std::dynamic_extent, Word>;
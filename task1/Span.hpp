@@ -1,11 +1,22 @@
+#pragma once
+
 #include <span>
 #include <concepts>
 #include <cstdlib>
 #include <iterator>
 #include <cassert>
 
+#include "ViewCommon.hpp"
+
 
 namespace detail {
+  template
+    < class T
+    , std::size_t N
+    , std::size_t step
+    >
+  class SpanWindows;
+
   template
     < std::size_t extent
     >
@@ -99,6 +110,7 @@ class Span : detail::SpanBase<extent> {
   template
     < class R 
     >
+    requires requires (R&& range) { range.size(); std::data(range); }
   explicit(extent != std::dynamic_extent)
   constexpr Span(R&& range) : Base(range.size()), data_(std::data(range)) {}
 
@@ -107,7 +119,7 @@ class Span : detail::SpanBase<extent> {
     , std::size_t N 
     >
   explicit(extent != std::dynamic_extent && N == std::dynamic_extent)
-  constexpr Span(const Span<U, N>& source) noexcept : Base(source.size()), data_(source.data()) {}
+  constexpr Span(const Span<U, N>& source) noexcept : Base(source.Size()), data_(source.Data()) {}
 
   constexpr Span(const Span& other) noexcept = default;
 
@@ -115,6 +127,18 @@ class Span : detail::SpanBase<extent> {
 
   Span& operator=(const Span& other) noexcept = default;
 
+  // Evaluates a lazy element-wise expression into the viewed elements, in
+  // a single pass
+
+  template
+    < class E
+    >
+    requires detail::kIsLazyExpr<E>
+  constexpr Span& operator=(const E& expr) {
+    expr.AssignTo(*this);
+    return *this;
+  }
+
   // Element access methods
 
   constexpr reference Front() const {
@@ -171,6 +195,29 @@ class Span : detail::SpanBase<extent> {
     return {Data() + (Size() - Count), Count};
   }
 
+  // Consecutive non-overlapping Span<T, Count>, stepping by Count
+
+  template
+    < std::size_t Count
+    , ChunkRemainder remainder = ChunkRemainder::Drop
+    >
+  constexpr detail::SpanWindows<element_type, Count, Count> Chunks() const {
+    static_assert(Count > 0);
+    assert(remainder != ChunkRemainder::Exact || Size() % Count == 0);
+    return {Data(), Size()};
+  }
+
+  // Overlapping Span<T, Count> starting at every element: Size() - Count + 1
+  // of them, none if Size() < Count
+
+  template
+    < std::size_t Count
+    >
+  constexpr detail::SpanWindows<element_type, Count, 1> Windows() const {
+    static_assert(Count > 0);
+    return {Data(), Size()};
+  }
+
   // Iterators
 
   constexpr iterator begin() const noexcept { 
@@ -195,6 +242,81 @@ class Span : detail::SpanBase<extent> {
 };
 
 
+namespace detail {
+  template
+    < class T
+    , std::size_t N
+    , std::size_t step
+    >
+  class SpanWindows {
+   public:
+    struct Iterator {
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = Span<T, N>;
+
+      constexpr Iterator() = default;
+      constexpr explicit Iterator(T* ptr) : ptr_(ptr) {}
+
+      constexpr Span<T, N> operator*() const {
+        return Span<T, N>{ptr_, N};
+      }
+
+      constexpr Iterator& operator++() {
+        ptr_ += step;
+        return *this;
+      }
+
+      constexpr Iterator operator++(int) {
+        Iterator copy = *this;
+        ptr_ += step;
+        return copy;
+      }
+
+      constexpr bool operator==(const Iterator& other) const {
+        return ptr_ == other.ptr_;
+      }
+
+     private:
+      T* ptr_ = nullptr;
+    };
+
+    constexpr SpanWindows(T* data, std::size_t size)
+      : data_(data), size_(size), count_(size < N ? 0 : (size - N) / step + 1) {}
+
+    constexpr std::size_t Size() const noexcept {
+      return count_;
+    }
+
+    [[nodiscard]] constexpr bool Empty() const noexcept {
+      return count_ == 0;
+    }
+
+    constexpr Span<T, N> operator[](std::size_t idx) const {
+      return Span<T, N>{data_ + idx * step, N};
+    }
+
+    // Elements after the last chunk
+    constexpr Span<T> Remainder() const requires (step == N) {
+      return {data_ + count_ * N, size_ - count_ * N};
+    }
+
+    constexpr Iterator begin() const noexcept {
+      return Iterator(data_);
+    }
+
+    constexpr Iterator end() const noexcept {
+      return Iterator(data_ + count_ * step);
+    }
+
+   private:
+    T* data_;
+    std::size_t size_;
+    std::size_t count_;
+  };
+}
+
+
 // Deduction guides
 
 template
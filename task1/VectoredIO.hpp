@@ -0,0 +1,397 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "Span.hpp"
+
+
+// Scatter/gather I/O over Spans: the kernel reads the fragments in place,
+// so a response assembled from many pieces goes out without first being
+// copied into one buffer. Both functions retry on EINTR and on short
+// transfers; any other error, EAGAIN included, stops them with the bytes
+// transferred so far, so that a non-blocking caller can resume from there.
+// Only readv/writev are used: batching submissions through io_uring is out
+// of scope for this header.
+
+// Outcome of WriteAll/ReadAll: done bytes were transferred, and error is 0
+// or the errno of the call that stopped the transfer
+struct IoResult {
+  std::size_t done;
+  int error;
+};
+
+namespace detail {
+  // iovecs handed to one system call; well under IOV_MAX on every platform
+  inline constexpr std::size_t kIoBatch = 64;
+
+  // Fills batch from fragments[index] on, skipping the first offset bytes
+  // of that fragment; returns the number of entries used
+  template
+    < class Byte
+    >
+  std::size_t FillIoBatch(Span<const Span<Byte>> fragments, std::size_t index, std::size_t offset,
+                          iovec (&batch)[kIoBatch]) {
+    std::size_t used = 0;
+    for (; index < fragments.Size() && used < kIoBatch; ++index, offset = 0) {
+      const auto& fragment = fragments[index];
+      if (fragment.Size() == offset) {
+        continue;
+      }
+      batch[used].iov_base = const_cast<std::byte*>(fragment.Data() + offset);
+      batch[used].iov_len = fragment.Size() - offset;
+      ++used;
+    }
+    return used;
+  }
+
+  // Moves (index, offset) forward by done bytes
+  template
+    < class Byte
+    >
+  void AdvanceIo(Span<const Span<Byte>> fragments, std::size_t& index, std::size_t& offset, std::size_t done) {
+    while (index < fragments.Size()) {
+      std::size_t left = fragments[index].Size() - offset;
+      if (done < left) {
+        offset += done;
+        return;
+      }
+      done -= left;
+      ++index;
+      offset = 0;
+    }
+  }
+
+  template
+    < class Byte
+    , class Call
+    >
+  IoResult TransferAll(Span<const Span<Byte>> fragments, std::size_t skip, Call call) {
+    IoResult result{skip, 0};
+    std::size_t index = 0;
+    std::size_t offset = 0;
+    AdvanceIo(fragments, index, offset, skip);
+    iovec batch[kIoBatch];
+    while (true) {
+      std::size_t used = FillIoBatch(fragments, index, offset, batch);
+      if (used == 0) {
+        return result;
+      }
+      ssize_t done = call(batch, static_cast<int>(used));
+      if (done < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        result.error = errno;
+        return result;
+      }
+      if (done == 0) {
+        return result;
+      }
+      result.done += static_cast<std::size_t>(done);
+      AdvanceIo(fragments, index, offset, static_cast<std::size_t>(done));
+    }
+  }
+}
+
+
+// Writes every fragment to fd, in order, starting skip bytes in: pass the
+// done of an earlier call that stopped on EAGAIN to resume it
+inline IoResult WriteAll(int fd, Span<const Span<const std::byte>> fragments, std::size_t skip = 0) {
+  return detail::TransferAll(fragments, skip, [fd](const iovec* batch, int count) {
+    return ::writev(fd, batch, count);
+  });
+}
+
+// Fills the buffers from fd, in order, starting skip bytes in, until they
+// are full or the input ends
+inline IoResult ReadAll(int fd, Span<const Span<std::byte>> buffers, std::size_t skip = 0) {
+  return detail::TransferAll(buffers, skip, [fd](const iovec* batch, int count) {
+    return ::readv(fd, batch, count);
+  });
+}
+
+
+// WriteAll/ReadAll through io_uring, with the raw system calls rather than
+// liburing. A transfer queues one entry per kIoBatch fragments, or per run
+// of adjacent fragments in one registered buffer, links the entries so the
+// kernel runs them in order, and submits them all with one io_uring_enter
+// that also waits for their completions. Registered buffers are pinned once
+// by RegisterBuffers instead of on every transfer. Transfers go at the
+// current file position, as write and read do, so files, pipes and sockets
+// are all served. Errors and resuming from done work as for WriteAll,
+// except that the kernel waits for a descriptor to become ready rather
+// than failing with EAGAIN, O_NONBLOCK or not. One ring serves one thread
+// at a time.
+class IoUring {
+ public:
+  static constexpr unsigned kDefaultEntries = 64;
+
+  explicit IoUring(unsigned entries = kDefaultEntries) {
+    io_uring_params params{};
+    fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd_ < 0) {
+      error_ = errno;
+      return;
+    }
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+    }
+    sq_ring_ = Map(sq_size_, IORING_OFF_SQ_RING);
+    cq_ring_ = params.features & IORING_FEAT_SINGLE_MMAP ? sq_ring_ : Map(cq_size_, IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = reinterpret_cast<io_uring_sqe*>(Map(sqes_size_, IORING_OFF_SQES));
+    if (sq_ring_ == nullptr || cq_ring_ == nullptr || sqes_ == nullptr) {
+      error_ = errno;
+      return;
+    }
+    entries_ = params.sq_entries;
+    sq_tail_ = reinterpret_cast<unsigned*>(sq_ring_ + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq_ring_ + params.sq_off.ring_mask);
+    cq_head_ = reinterpret_cast<unsigned*>(cq_ring_ + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq_ring_ + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq_ring_ + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ring_ + params.cq_off.cqes);
+    // Entry i always sits in slot i of the array
+    auto* array = reinterpret_cast<unsigned*>(sq_ring_ + params.sq_off.array);
+    for (unsigned i = 0; i < entries_; ++i) {
+      array[i] = i;
+    }
+    iovecs_.resize(std::size_t{entries_} * detail::kIoBatch);
+  }
+
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+
+  ~IoUring() {
+    if (sqes_ != nullptr) {
+      ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+      ::munmap(cq_ring_, cq_size_);
+    }
+    if (sq_ring_ != nullptr) {
+      ::munmap(sq_ring_, sq_size_);
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  // 0, or the errno of the setup that failed; every transfer then fails
+  // with it and nothing done
+  int Error() const noexcept {
+    return error_;
+  }
+
+  // Pins buffers for the transfers of fragments that lie inside one of
+  // them, replacing any buffers registered before; returns 0 or the errno
+  int RegisterBuffers(Span<const Span<std::byte>> buffers) {
+    if (error_ != 0) {
+      return error_;
+    }
+    if (!buffers_.empty()) {
+      ::syscall(__NR_io_uring_register, fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+      buffers_.clear();
+    }
+    std::vector<iovec> registered;
+    for (const auto& buffer : buffers) {
+      registered.push_back({buffer.Data(), buffer.Size()});
+    }
+    if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, registered.data(),
+                  static_cast<unsigned>(registered.size())) < 0) {
+      return errno;
+    }
+    buffers_ = std::move(registered);
+    return 0;
+  }
+
+  IoResult WriteAll(int fd, Span<const Span<const std::byte>> fragments, std::size_t skip = 0) {
+    return TransferAll(fd, fragments, skip, IORING_OP_WRITEV, IORING_OP_WRITE_FIXED);
+  }
+
+  IoResult ReadAll(int fd, Span<const Span<std::byte>> buffers, std::size_t skip = 0) {
+    return TransferAll(fd, buffers, skip, IORING_OP_READV, IORING_OP_READ_FIXED);
+  }
+
+ private:
+  // Longest fixed transfer queued as one entry
+  static constexpr std::size_t kMaxFixed = std::size_t{1} << 30;
+
+  std::byte* Map(std::size_t size, std::uint64_t offset) {
+    void* ring = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                        static_cast<off_t>(offset));
+    return ring == MAP_FAILED ? nullptr : static_cast<std::byte*>(ring);
+  }
+
+  // Index of the registered buffer holding the size bytes at data, or -1
+  int RegisteredBuffer(const std::byte* data, std::size_t size) const {
+    for (std::size_t i = 0; i < buffers_.size(); ++i) {
+      const auto* begin = static_cast<const std::byte*>(buffers_[i].iov_base);
+      if (data >= begin && data + size <= begin + buffers_[i].iov_len) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  // Submits the count queued entries and waits until they all completed;
+  // returns 0 or the errno of io_uring_enter
+  int SubmitAndWait(unsigned count) {
+    unsigned submitted = 0;
+    while (true) {
+      unsigned ready = std::atomic_ref(*cq_tail_).load(std::memory_order_acquire) - *cq_head_;
+      if (submitted == count && ready == count) {
+        return 0;
+      }
+      long entered = ::syscall(__NR_io_uring_enter, fd_, count - submitted, count - ready, IORING_ENTER_GETEVENTS,
+                               nullptr, 0);
+      if (entered < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return errno;
+      }
+      submitted += static_cast<unsigned>(entered);
+    }
+  }
+
+  template
+    < class Byte
+    >
+  IoResult TransferAll(int fd, Span<const Span<Byte>> fragments, std::size_t skip, std::uint8_t vectored,
+                       std::uint8_t fixed) {
+    IoResult result{skip, error_};
+    if (error_ != 0) {
+      return result;
+    }
+    std::size_t index = 0;
+    std::size_t offset = 0;
+    detail::AdvanceIo(fragments, index, offset, skip);
+    while (true) {
+      // Queues as much of the rest as the ring takes, at (next, at)
+      std::size_t next = index;
+      std::size_t at = offset;
+      std::size_t requested = 0;
+      unsigned count = 0;
+      unsigned tail = *sq_tail_;
+      io_uring_sqe* sqe = nullptr;
+      while (count < entries_ && next < fragments.Size()) {
+        if (fragments[next].Size() == at) {
+          ++next;
+          at = 0;
+          continue;
+        }
+        const std::byte* data = fragments[next].Data() + at;
+        std::size_t size = fragments[next].Size() - at;
+        sqe = &sqes_[(tail + count) & sq_mask_];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->fd = fd;
+        sqe->off = ~std::uint64_t{0};
+        sqe->flags = IOSQE_IO_LINK;
+        sqe->user_data = count;
+        if (int buffer = RegisteredBuffer(data, size); buffer >= 0) {
+          size = std::min(size, kMaxFixed);
+          at += size;
+          // Fragments that carry on where this one ends join its entry
+          while (at == fragments[next].Size() && next + 1 < fragments.Size() &&
+                 fragments[next + 1].Data() == data + size && fragments[next + 1].Size() <= kMaxFixed - size &&
+                 RegisteredBuffer(data, size + fragments[next + 1].Size()) == buffer) {
+            ++next;
+            at = fragments[next].Size();
+            size += at;
+          }
+          sqe->opcode = fixed;
+          sqe->addr = reinterpret_cast<std::uintptr_t>(data);
+          sqe->len = static_cast<std::uint32_t>(size);
+          sqe->buf_index = static_cast<std::uint16_t>(buffer);
+          requested += size;
+        } else {
+          iovec* batch = &iovecs_[std::size_t{count} * detail::kIoBatch];
+          unsigned used = 0;
+          for (; next < fragments.Size() && used < detail::kIoBatch; ++next, at = 0) {
+            data = fragments[next].Data() + at;
+            size = fragments[next].Size() - at;
+            if (size != 0 && RegisteredBuffer(data, size) >= 0) {
+              break;
+            }
+            if (size != 0) {
+              batch[used++] = {const_cast<std::byte*>(data), size};
+              requested += size;
+            }
+          }
+          sqe->opcode = vectored;
+          sqe->addr = reinterpret_cast<std::uintptr_t>(batch);
+          sqe->len = used;
+        }
+        ++count;
+      }
+      if (count == 0) {
+        return result;
+      }
+      sqe->flags = 0;
+      std::atomic_ref(*sq_tail_).store(tail + count, std::memory_order_release);
+      int entered = SubmitAndWait(count);
+
+      // Linked entries run in order and a short or failed one cancels the
+      // rest, so the bytes done are the sum of the completions
+      std::size_t done = 0;
+      int error = 0;
+      unsigned failed = count;
+      unsigned head = *cq_head_;
+      unsigned cq_tail = std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+      for (; head != cq_tail; ++head) {
+        const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+        if (cqe.res >= 0) {
+          done += static_cast<std::size_t>(cqe.res);
+        } else if (cqe.res != -ECANCELED && cqe.user_data < failed) {
+          failed = static_cast<unsigned>(cqe.user_data);
+          error = -cqe.res;
+        }
+      }
+      std::atomic_ref(*cq_head_).store(head, std::memory_order_release);
+      result.done += done;
+      detail::AdvanceIo(fragments, index, offset, done);
+      if (entered != 0 || (error != 0 && error != EINTR)) {
+        result.error = entered != 0 ? entered : error;
+        return result;
+      }
+      if (done == 0 && error == 0) {
+        return result;
+      }
+    }
+  }
+
+  int fd_ = -1;
+  int error_ = 0;
+  unsigned entries_ = 0;
+  std::byte* sq_ring_ = nullptr;
+  std::byte* cq_ring_ = nullptr;
+  std::size_t sq_size_ = 0;
+  std::size_t cq_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  std::size_t sqes_size_ = 0;
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+  // iovecs of the queued entries, kIoBatch per entry
+  std::vector<iovec> iovecs_;
+  std::vector<iovec> buffers_;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+
+// Declarations shared by Span and task2/Slice, so that neither header has
+// to include the other
+
+
+// What Chunks<N>() does with the last Size() % N elements
+enum class ChunkRemainder {
+  Drop,   // left out of the iteration, reachable through Remainder()
+  Exact,  // Size() must be a multiple of N
+};
+
+
+namespace detail {
+  // Marks the lazy element-wise expressions of task2/Expr.hpp, which Span
+  // and Slice evaluate on assignment
+  template
+    < class E
+    >
+  inline constexpr bool kIsLazyExpr = false;
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Slice.hpp"
+#include "../task1/Span.hpp"
+
+
+// Element-wise arithmetic on Spans and Slices without temporaries:
+//   out = a * b + 2.0 * c;
+// builds a tree of lazy nodes holding the operand views and evaluates it in
+// one fused loop when assigned to a Span or Slice. Operands are views,
+// expressions or arithmetic scalars, which are broadcast; Map(f, ...)
+// applies any element-wise function. All views must have the same size,
+// and an operand may be the destination itself but must not overlap it in
+// any other way. When every operand and the destination are contiguous and
+// one of them has a static extent, the loop bound is a constant.
+
+namespace detail {
+  template
+    < class U
+    >
+  inline constexpr bool kIsLazyView = false;
+
+  template
+    < class T
+    , std::size_t extent
+    >
+  inline constexpr bool kIsLazyView<Span<T, extent>> = true;
+
+  template
+    < class T
+    , std::size_t extent
+    , std::ptrdiff_t stride
+    >
+  inline constexpr bool kIsLazyView<Slice<T, extent, stride>> = true;
+
+  template
+    < class U
+    >
+  concept LazyOperand = kIsLazyView<U> || kIsLazyExpr<U>;
+
+  template
+    < class U
+    >
+  concept LazyScalar = std::is_arithmetic_v<U>;
+
+  template
+    < class U
+    >
+  inline constexpr std::size_t kLazyExtent = std::dynamic_extent;
+
+  template
+    < class T
+    , std::size_t extent
+    >
+  inline constexpr std::size_t kLazyExtent<Span<T, extent>> = extent;
+
+  template
+    < class T
+    , std::size_t extent
+    , std::ptrdiff_t stride
+    >
+  inline constexpr std::size_t kLazyExtent<Slice<T, extent, stride>> = extent;
+
+  template
+    < class U
+    >
+  inline constexpr bool kLazyContiguous = true;
+
+  template
+    < class T
+    , std::size_t extent
+    , std::ptrdiff_t stride
+    >
+  inline constexpr bool kLazyContiguous<Slice<T, extent, stride>> = stride == 1;
+
+  // Operands as evaluated: views become bare pointers copied into the
+  // evaluating function, so the loop does not reload them after each store
+
+  template
+    < class T
+    >
+  struct LazyPointer {
+    T* data;
+
+    T& operator[](std::size_t idx) const {
+      return data[idx];
+    }
+  };
+
+  template
+    < class T
+    >
+  struct LazyStrided {
+    T* data;
+    std::ptrdiff_t stride;
+
+    T& operator[](std::size_t idx) const {
+      return data[stride * static_cast<std::ptrdiff_t>(idx)];
+    }
+  };
+
+  template
+    < class T
+    >
+  struct LazyBroadcast {
+    T value;
+
+    T operator[](std::size_t) const {
+      return value;
+    }
+  };
+
+  template
+    < class Op
+    , class... Bound
+    >
+  struct LazyBound {
+    [[no_unique_address]] Op op;
+    std::tuple<Bound...> operands;
+
+    decltype(auto) operator[](std::size_t idx) const {
+      return std::apply([&](const Bound&... bound) -> decltype(auto) {
+        return op(bound[idx]...);
+      }, operands);
+    }
+  };
+
+  template
+    < class T
+    , std::size_t extent
+    >
+  LazyPointer<T> LazyBind(const Span<T, extent>& view) {
+    return {view.Data()};
+  }
+
+  template
+    < class T
+    , std::size_t extent
+    , std::ptrdiff_t stride
+    >
+  auto LazyBind(const Slice<T, extent, stride>& view) {
+    if constexpr (stride == 1) {
+      return LazyPointer<T>{view.Data()};
+    } else {
+      return LazyStrided<T>{view.Data(), view.Stride()};
+    }
+  }
+
+  template
+    < LazyScalar U
+    >
+  LazyBroadcast<U> LazyBind(const U& value) {
+    return {value};
+  }
+
+  template
+    < class E
+    >
+    requires kIsLazyExpr<E>
+  auto LazyBind(const E& expr) {
+    return expr.Bind();
+  }
+
+  // Number of elements, std::dynamic_extent for scalars
+  template
+    < class U
+    >
+  std::size_t LazySize(const U& operand) {
+    if constexpr (LazyScalar<U>) {
+      return std::dynamic_extent;
+    } else {
+      return operand.Size();
+    }
+  }
+
+  // The static extent shared by extents, std::dynamic_extent if none has one
+  template
+    < std::size_t size
+    >
+  consteval std::size_t CommonLazyExtent(std::array<std::size_t, size> extents) {
+    std::size_t common = std::dynamic_extent;
+    for (std::size_t extent : extents) {
+      if (extent != std::dynamic_extent) {
+        if (common != std::dynamic_extent && common != extent) {
+          throw "operands of a lazy expression have different static extents";
+        }
+        common = extent;
+      }
+    }
+    return common;
+  }
+
+  template
+    < class Op
+    , class... Operands
+    >
+  class LazyExpr {
+   public:
+    static constexpr std::size_t extent = CommonLazyExtent<sizeof...(Operands)>({kLazyExtent<Operands>...});
+    static constexpr bool contiguous = (kLazyContiguous<Operands> && ...);
+
+    constexpr LazyExpr(Op op, const Operands&... operands) : op_(std::move(op)), operands_(operands...) {}
+
+    std::size_t Size() const {
+      return std::apply([](const Operands&... operands) {
+        std::size_t size = std::dynamic_extent;
+        ((size = size == std::dynamic_extent ? LazySize(operands) : size), ...);
+        assert(((LazySize(operands) == std::dynamic_extent || LazySize(operands) == size) && ...));
+        return size;
+      }, operands_);
+    }
+
+    LazyBound<Op, decltype(LazyBind(std::declval<const Operands&>()))...> Bind() const {
+      return std::apply([&](const Operands&... operands) {
+        return LazyBound<Op, decltype(LazyBind(operands))...>{op_, {LazyBind(operands)...}};
+      }, operands_);
+    }
+
+    template
+      < class Dst
+      >
+    void AssignTo(const Dst& dst) const {
+      constexpr std::size_t size = CommonLazyExtent<2>({extent, kLazyExtent<Dst>});
+      assert(Size() == dst.Size());
+      const auto source = Bind();
+      const auto out = LazyBind(dst);
+      if constexpr (size != std::dynamic_extent && contiguous && kLazyContiguous<Dst>) {
+        for (std::size_t i = 0; i < size; ++i) {
+          out[i] = source[i];
+        }
+      } else {
+        const std::size_t count = dst.Size();
+        for (std::size_t i = 0; i < count; ++i) {
+          out[i] = source[i];
+        }
+      }
+    }
+
+   private:
+    [[no_unique_address]] Op op_;
+    std::tuple<Operands...> operands_;
+  };
+
+  template
+    < class Op
+    , class... Operands
+    >
+  inline constexpr bool kIsLazyExpr<LazyExpr<Op, Operands...>> = true;
+
+  template
+    < class L
+    , class R
+    >
+  concept LazyBinary = (LazyOperand<L> && (LazyOperand<R> || LazyScalar<R>)) || (LazyScalar<L> && LazyOperand<R>);
+}
+
+
+template
+  < class L
+  , class R
+  >
+  requires detail::LazyBinary<L, R>
+constexpr auto operator+(const L& lhs, const R& rhs) {
+  return detail::LazyExpr<std::plus<>, L, R>({}, lhs, rhs);
+}
+
+template
+  < class L
+  , class R
+  >
+  requires detail::LazyBinary<L, R>
+constexpr auto operator-(const L& lhs, const R& rhs) {
+  return detail::LazyExpr<std::minus<>, L, R>({}, lhs, rhs);
+}
+
+template
+  < class L
+  , class R
+  >
+  requires detail::LazyBinary<L, R>
+constexpr auto operator*(const L& lhs, const R& rhs) {
+  return detail::LazyExpr<std::multiplies<>, L, R>({}, lhs, rhs);
+}
+
+template
+  < class L
+  , class R
+  >
+  requires detail::LazyBinary<L, R>
+constexpr auto operator/(const L& lhs, const R& rhs) {
+  return detail::LazyExpr<std::divides<>, L, R>({}, lhs, rhs);
+}
+
+template
+  < detail::LazyOperand U
+  >
+constexpr auto operator-(const U& operand) {
+  return detail::LazyExpr<std::negate<>, U>({}, operand);
+}
+
+// Lazy f(operands[i]...), e.g. out = Map(fmaf, a, b, c)
+template
+  < class F
+  , class... Operands
+  >
+  requires ((detail::LazyOperand<Operands> || detail::LazyScalar<Operands>) && ...) &&
+           (detail::LazyOperand<Operands> || ...)
+constexpr auto Map(F f, const Operands&... operands) {
+  return detail::LazyExpr<F, Operands...>(std::move(f), operands...);
+}
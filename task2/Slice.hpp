@@ -1,3 +1,5 @@
+#pragma once
+
 #include <span>
 #include <concepts>
 #include <cstdlib>
@@ -5,6 +7,8 @@
 #include <iterator>
 #include <cassert>
 
+#include "../task1/ViewCommon.hpp"
+
 
 inline constexpr std::ptrdiff_t dynamic_stride = -1;
 
@@ -38,7 +42,7 @@ namespace detail {
     >
   struct StrideImpl {
     constexpr StrideImpl() noexcept = default;
-    constexpr StrideImpl(std::ptrdiff_t s) {}
+    constexpr StrideImpl(std::ptrdiff_t) {}
     constexpr std::ptrdiff_t Stride() const {
       return stride_;
     }
@@ -58,6 +62,14 @@ namespace detail {
   constexpr std::size_t CeilDiv(std::size_t a, std::ptrdiff_t b) {
     return (a + b - 1) / b;
   }
+
+  template
+    < class T
+    , std::size_t N
+    , std::ptrdiff_t stride
+    , std::size_t step
+    >
+  class SliceWindows;
 }
 
 
@@ -252,6 +264,18 @@ class Slice {
 
   ~Slice() noexcept = default;
 
+  // Evaluates a lazy element-wise expression into the viewed elements, in
+  // a single pass
+
+  template
+    < class E
+    >
+    requires detail::kIsLazyExpr<E>
+  constexpr Slice& operator=(const E& expr) {
+    expr.AssignTo(*this);
+    return *this;
+  }
+
   // Observers
 
   constexpr size_type Size() const noexcept {
@@ -322,6 +346,29 @@ class Slice {
     return {Data(), Size() - count, Stride()};
   }
 
+  // Consecutive non-overlapping Slice<T, count, stride>, stepping by count
+  // elements
+
+  template
+    < std::size_t count
+    , ChunkRemainder remainder = ChunkRemainder::Drop
+    >
+  constexpr detail::SliceWindows<element_type, count, stride, count> Chunks() const {
+    static_assert(count > 0);
+    assert(remainder != ChunkRemainder::Exact || Size() % count == 0);
+    return {Data(), Size(), Stride()};
+  }
+
+  // Overlapping Slice<T, count, stride> starting at every element
+
+  template
+    < std::size_t count
+    >
+  constexpr detail::SliceWindows<element_type, count, stride, 1> Windows() const {
+    static_assert(count > 0);
+    return {Data(), Size(), Stride()};
+  }
+
   constexpr Slice <element_type, std::dynamic_extent, dynamic_stride> Skip(std::ptrdiff_t skip) const {
     auto new_stride = Stride() * skip;
     return {Data(), detail::CeilDiv(Size(), skip), new_stride};
@@ -375,6 +422,95 @@ private:
 };
 
 
+namespace detail {
+  template
+    < class T
+    , std::size_t N
+    , std::ptrdiff_t stride
+    , std::size_t step
+    >
+  class SliceWindows : StrideImpl<stride> {
+   private:
+    using TStride = StrideImpl<stride>;
+    using TStride::Stride;
+
+   public:
+    struct Iterator : StrideImpl<stride> {
+     private:
+      using TStride = StrideImpl<stride>;
+      using TStride::Stride;
+
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = Slice<T, N, stride>;
+
+      constexpr Iterator() = default;
+      constexpr Iterator(T* ptr, std::ptrdiff_t s) : TStride(s), ptr_(ptr) {}
+
+      constexpr Slice<T, N, stride> operator*() const {
+        return {ptr_, N, Stride()};
+      }
+
+      constexpr Iterator& operator++() {
+        ptr_ += static_cast<std::ptrdiff_t>(step) * Stride();
+        return *this;
+      }
+
+      constexpr Iterator operator++(int) {
+        Iterator copy = *this;
+        ++*this;
+        return copy;
+      }
+
+      constexpr bool operator==(const Iterator& other) const {
+        return ptr_ == other.ptr_;
+      }
+
+     private:
+      T* ptr_ = nullptr;
+    };
+
+    constexpr SliceWindows(T* data, std::size_t size, std::ptrdiff_t s)
+      : TStride(s), data_(data), size_(size), count_(size < N ? 0 : (size - N) / step + 1) {}
+
+    constexpr std::size_t Size() const noexcept {
+      return count_;
+    }
+
+    [[nodiscard]] constexpr bool Empty() const noexcept {
+      return count_ == 0;
+    }
+
+    constexpr Slice<T, N, stride> operator[](std::size_t idx) const {
+      return {Offset(idx * step), N, Stride()};
+    }
+
+    // Elements after the last chunk
+    constexpr Slice<T, std::dynamic_extent, stride> Remainder() const requires (step == N) {
+      return {Offset(count_ * N), size_ - count_ * N, Stride()};
+    }
+
+    constexpr Iterator begin() const noexcept {
+      return Iterator(data_, Stride());
+    }
+
+    constexpr Iterator end() const noexcept {
+      return Iterator(Offset(count_ * step), Stride());
+    }
+
+   private:
+    constexpr T* Offset(std::size_t elements) const {
+      return data_ + static_cast<std::ptrdiff_t>(elements) * Stride();
+    }
+
+    T* data_;
+    std::size_t size_;
+    std::size_t count_;
+  };
+}
+
+
 // Comparison of Slice
 
 template
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "FixedString.hpp"
+#include "../task1/Span.hpp"
+
+
+// Formatting into a caller's buffer with the format string parsed while the
+// program is compiled:
+//   Format<"ts={} id={:x} px={:.2f}"_cstr>(out, ts, id, px)
+// Replacement fields:
+//   {} or {:d}  integers in decimal, floats in shortest round-trip form,
+//               bool as true/false, char, and anything convertible to
+//               std::string_view
+//   {:x} {:X}   integers in lower/upper case hexadecimal
+//   {:.Nf}      floats with N digits after the point
+// and {{ and }} for literal braces. Nothing allocates and the output is not
+// NUL-terminated.
+
+namespace detail {
+  // Not constexpr, so reaching it during constant evaluation stops the
+  // compilation with the message in the diagnostic
+  inline void FormatError(const char* /*message*/) {}
+
+  enum class FormatKind : std::uint8_t {
+    Literal,
+    Default,
+    Hex,
+    HexUpper,
+    Fixed,
+  };
+
+  struct FormatStep {
+    FormatKind kind = FormatKind::Literal;
+    std::size_t begin = 0;   // literal text in the format string
+    std::size_t length = 0;
+    std::size_t arg = 0;     // argument of a replacement field
+    int precision = 0;
+  };
+
+  // Calls step for every literal run and replacement field of format;
+  // returns how many there were
+  template
+    < class OnStep
+    >
+  constexpr std::size_t ParseFormat(std::string_view format, OnStep on_step) {
+    std::size_t steps = 0;
+    std::size_t args = 0;
+    std::size_t literal = 0;
+    auto flush = [&](std::size_t end) {
+      if (end > literal) {
+        on_step(FormatStep{FormatKind::Literal, literal, end - literal, 0, 0});
+        ++steps;
+      }
+    };
+    for (std::size_t i = 0; i < format.size(); ++i) {
+      if (format[i] == '}') {
+        if (i + 1 == format.size() || format[i + 1] != '}') {
+          FormatError("format: unmatched '}'");
+        }
+        flush(i + 1);
+        literal = ++i + 1;
+      } else if (format[i] == '{') {
+        if (i + 1 < format.size() && format[i + 1] == '{') {
+          flush(i + 1);
+          literal = ++i + 1;
+          continue;
+        }
+        flush(i);
+        std::size_t close = format.find('}', i);
+        if (close == std::string_view::npos) {
+          FormatError("format: unterminated '{'");
+        }
+        std::string_view spec = format.substr(i + 1, close - i - 1);
+        FormatStep step{FormatKind::Default, 0, 0, args++, 0};
+        if (spec == "" || spec == ":d") {
+          step.kind = FormatKind::Default;
+        } else if (spec == ":x") {
+          step.kind = FormatKind::Hex;
+        } else if (spec == ":X") {
+          step.kind = FormatKind::HexUpper;
+        } else if (spec.size() >= 4 && spec.substr(0, 2) == ":." && spec.back() == 'f') {
+          step.kind = FormatKind::Fixed;
+          for (char c : spec.substr(2, spec.size() - 3)) {
+            if (c < '0' || c > '9') {
+              FormatError("format: bad precision");
+            }
+            step.precision = step.precision * 10 + (c - '0');
+          }
+        } else {
+          FormatError("format: unsupported replacement field");
+        }
+        on_step(step);
+        ++steps;
+        i = close;
+        literal = close + 1;
+      }
+    }
+    flush(format.size());
+    return steps;
+  }
+
+  template
+    < FixedString<256> format
+    >
+  inline constexpr auto kFormatSteps = [] {
+    std::array<FormatStep, ParseFormat(format, [](const FormatStep&) {})> steps{};
+    std::size_t next = 0;
+    ParseFormat(format, [&](const FormatStep& step) {
+      steps[next++] = step;
+    });
+    return steps;
+  }();
+
+  template
+    < FixedString<256> format
+    >
+  inline constexpr std::size_t kFormatArgs = [] {
+    std::size_t args = 0;
+    for (const auto& step : kFormatSteps<format>) {
+      args += step.kind != FormatKind::Literal;
+    }
+    return args;
+  }();
+
+  template
+    < class U
+    >
+  concept FormatInteger = std::integral<U> && !std::same_as<U, bool> && !std::same_as<U, char>;
+
+  template
+    < class U
+    >
+  concept FormatString = !FormatInteger<U> && !std::floating_point<U> && !std::same_as<U, bool> &&
+                         !std::same_as<U, char> && std::convertible_to<const U&, std::string_view>;
+
+  // Longest output of one replacement field, 0 when it has no bound
+  template
+    < class U
+    >
+  constexpr std::size_t FormatFieldBound(FormatKind kind) {
+    if constexpr (FormatInteger<U>) {
+      if (kind == FormatKind::Hex || kind == FormatKind::HexUpper) {
+        return sizeof(U) * 2 + std::is_signed_v<U>;
+      }
+      return std::numeric_limits<U>::digits10 + 1 + std::is_signed_v<U>;
+    } else if constexpr (std::same_as<U, float> || std::same_as<U, double>) {
+      return kind == FormatKind::Fixed ? 0 : 24;
+    } else if constexpr (std::same_as<U, bool>) {
+      return 5;
+    } else if constexpr (std::same_as<U, char>) {
+      return 1;
+    } else {
+      return 0;
+    }
+  }
+
+  template
+    < FixedString<256> format
+    , class... Args
+    >
+  consteval std::size_t FormatBound() {
+    constexpr auto& steps = kFormatSteps<format>;
+    std::array<std::size_t (*)(FormatKind), sizeof...(Args)> bounds{&FormatFieldBound<Args>...};
+    std::size_t total = 0;
+    for (const auto& step : steps) {
+      if (step.kind == FormatKind::Literal) {
+        total += step.length;
+      } else {
+        std::size_t bound = bounds[step.arg](step.kind);
+        if (bound == 0) {
+          return std::dynamic_extent;
+        }
+        total += bound;
+      }
+    }
+    return total;
+  }
+
+  inline constexpr char kDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+  // Writes the output front to back; checked cursors fail instead of
+  // running past the end
+  template
+    < bool checked
+    >
+  struct FormatCursor {
+    char* pos;
+    char* end;
+
+    bool Put(const char* data, std::size_t size) {
+      if (checked && static_cast<std::size_t>(end - pos) < size) {
+        return false;
+      }
+      std::memcpy(pos, data, size);
+      pos += size;
+      return true;
+    }
+
+    template
+      < std::size_t size
+      >
+    bool Put(const char* data) {
+      if (checked && static_cast<std::size_t>(end - pos) < size) {
+        return false;
+      }
+      std::memcpy(pos, data, size);
+      pos += size;
+      return true;
+    }
+  };
+
+  // Decimal digits of value, two at a time, ending at last
+  template
+    < class U
+    >
+  char* FormatDecimal(char* last, U value) {
+    while (value >= 100) {
+      last -= 2;
+      std::memcpy(last, kDigitPairs + (value % 100) * 2, 2);
+      value /= 100;
+    }
+    if (value >= 10) {
+      last -= 2;
+      std::memcpy(last, kDigitPairs + value * 2, 2);
+    } else {
+      *--last = static_cast<char>('0' + value);
+    }
+    return last;
+  }
+
+  template
+    < class U
+    >
+  char* FormatHex(char* last, U value, const char* digits) {
+    do {
+      *--last = digits[value & 0xf];
+      value >>= 4;
+    } while (value != 0);
+    return last;
+  }
+
+  template
+    < bool checked
+    , class U
+    >
+  bool FormatField(FormatCursor<checked>& out, const U& value, const FormatStep& step) {
+    if constexpr (FormatInteger<U>) {
+      using Unsigned = std::make_unsigned_t<U>;
+      char buffer[std::numeric_limits<Unsigned>::digits10 + 2];
+      char* last = buffer + sizeof(buffer);
+      auto magnitude = static_cast<Unsigned>(value);
+      bool negative = false;
+      if constexpr (std::is_signed_v<U>) {
+        negative = value < 0;
+        magnitude = negative ? static_cast<Unsigned>(Unsigned{0} - magnitude) : magnitude;
+      }
+      char* first;
+      if (step.kind == FormatKind::Hex) {
+        first = FormatHex(last, magnitude, "0123456789abcdef");
+      } else if (step.kind == FormatKind::HexUpper) {
+        first = FormatHex(last, magnitude, "0123456789ABCDEF");
+      } else {
+        first = FormatDecimal(last, magnitude);
+      }
+      if (negative) {
+        *--first = '-';
+      }
+      return out.Put(first, static_cast<std::size_t>(last - first));
+    } else if constexpr (std::floating_point<U>) {
+      std::to_chars_result result;
+      if (step.kind == FormatKind::Fixed) {
+        result = std::to_chars(out.pos, out.end, value, std::chars_format::fixed, step.precision);
+      } else {
+        result = std::to_chars(out.pos, out.end, value);
+      }
+      if (result.ec != std::errc{}) {
+        return false;
+      }
+      out.pos = result.ptr;
+      return true;
+    } else if constexpr (std::same_as<U, bool>) {
+      return value ? out.template Put<4>("true") : out.template Put<5>("false");
+    } else if constexpr (std::same_as<U, char>) {
+      return out.template Put<1>(&value);
+    } else {
+      static_assert(FormatString<U>, "type cannot be formatted");
+      std::string_view string = value;
+      return out.Put(string.data(), string.size());
+    }
+  }
+
+  template
+    < class U
+    >
+  constexpr bool FormatAccepts(FormatKind kind) {
+    switch (kind) {
+      case FormatKind::Hex:
+      case FormatKind::HexUpper:
+        return FormatInteger<U>;
+      case FormatKind::Fixed:
+        return std::floating_point<U>;
+      default:
+        return FormatInteger<U> || std::floating_point<U> || std::same_as<U, bool> ||
+               std::same_as<U, char> || FormatString<U>;
+    }
+  }
+
+  template
+    < FixedString<256> format
+    , bool checked
+    , class... Args
+    >
+  bool FormatSteps(FormatCursor<checked>& out, const Args&... args) {
+    constexpr auto& steps = kFormatSteps<format>;
+    auto values = std::forward_as_tuple(args...);
+    return [&]<std::size_t... S>(std::index_sequence<S...>) {
+      return ([&] {
+        constexpr FormatStep step = steps[S];
+        if constexpr (step.kind == FormatKind::Literal) {
+          return out.template Put<step.length>(format.storage + step.begin);
+        } else {
+          using U = std::remove_cvref_t<std::tuple_element_t<step.arg, std::tuple<Args...>>>;
+          static_assert(FormatAccepts<U>(step.kind), "replacement field does not fit the argument type");
+          return FormatField(out, std::get<step.arg>(values), step);
+        }
+      }() && ...);
+    }(std::make_index_sequence<steps.size()>());
+  }
+}
+
+
+// Longest output of Format<format> with arguments of types Args, or
+// std::dynamic_extent when it is not bounded (strings, {:.Nf})
+template
+  < FixedString<256> format
+  , class... Args
+  >
+inline constexpr std::size_t kFormatMaxSize = detail::FormatBound<format, std::remove_cvref_t<Args>...>();
+
+// Writes the formatted arguments into out. Returns the number of characters
+// written, nothing if out is too small
+template
+  < FixedString<256> format
+  , class... Args
+  >
+std::optional<std::size_t> Format(Span<char> out, const Args&... args) {
+  static_assert(sizeof...(Args) == detail::kFormatArgs<format>, "argument count does not match the format");
+  detail::FormatCursor<true> cursor{out.Data(), out.Data() + out.Size()};
+  if (!detail::FormatSteps<format>(cursor, args...)) {
+    return std::nullopt;
+  }
+  return static_cast<std::size_t>(cursor.pos - out.Data());
+}
+
+// Buffers of a static extent that always fit are written without checks
+template
+  < FixedString<256> format
+  , std::size_t extent
+  , class... Args
+  >
+  requires (extent != std::dynamic_extent && extent >= kFormatMaxSize<format, Args...>)
+std::size_t Format(Span<char, extent> out, const Args&... args) {
+  static_assert(sizeof...(Args) == detail::kFormatArgs<format>, "argument count does not match the format");
+  detail::FormatCursor<false> cursor{out.Data(), out.Data() + out.Size()};
+  detail::FormatSteps<format>(cursor, args...);
+  return static_cast<std::size_t>(cursor.pos - out.Data());
+}
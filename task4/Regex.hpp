@@ -0,0 +1,798 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "FixedString.hpp"
+
+
+// Regular expressions compiled into a DFA while the program is compiled:
+//   Match<"[a-z]+=\\d+"_cstr>(text)   whole text matches
+//   Search<"ERROR|WARN"_cstr>(text)   leftmost-longest match, if any
+// Syntax, byte-based:
+//   literals, . (any byte but \n), [abc] [a-z] [^...],
+//   \d \w \s and their negations \D \W \S, \t \n \r, and \ before any
+//   other character for the character itself,
+//   grouping ( ), alternation |, and one quantifier per atom out of
+//   * + ? {m} {m,} {m,n}.
+// There are no captures, anchors or backreferences. A malformed pattern
+// fails to compile with a call to detail::RegexError in the diagnostic.
+
+namespace detail {
+  struct RegexCharSet {
+    std::array<std::uint64_t, 4> words{};
+
+    constexpr void Add(unsigned char c) {
+      words[c / 64] |= std::uint64_t{1} << (c % 64);
+    }
+
+    constexpr void AddRange(unsigned char lo, unsigned char hi) {
+      for (unsigned c = lo; c <= hi; ++c) {
+        Add(static_cast<unsigned char>(c));
+      }
+    }
+
+    constexpr bool Contains(unsigned char c) const {
+      return (words[c / 64] >> (c % 64) & 1) != 0;
+    }
+
+    constexpr void Invert() {
+      for (auto& word : words) {
+        word = ~word;
+      }
+    }
+
+    constexpr RegexCharSet& operator|=(const RegexCharSet& other) {
+      for (std::size_t i = 0; i < words.size(); ++i) {
+        words[i] |= other.words[i];
+      }
+      return *this;
+    }
+  };
+
+  // Not constexpr, so reaching it during constant evaluation stops the
+  // compilation with the message in the diagnostic
+  inline void RegexError(const char* /*message*/) {}
+
+  // Either consumes a byte of set and moves to next, or has up to two
+  // epsilon edges
+  struct RegexNfaState {
+    RegexCharSet set;
+    bool consumes = false;
+    int next = -1;
+    std::array<int, 2> epsilon = {-1, -1};
+  };
+
+  // Thompson fragment; end never has outgoing edges
+  struct RegexFragment {
+    int start;
+    int end;
+  };
+
+  class RegexParser {
+   public:
+    constexpr explicit RegexParser(std::string_view pattern) : pattern_(pattern) {}
+
+    constexpr std::vector<RegexNfaState> Parse(int& start, int& accept) {
+      RegexFragment whole = ParseAlternation();
+      if (pos_ != pattern_.size()) {
+        RegexError("regex: unbalanced ')'");
+      }
+      start = whole.start;
+      accept = whole.end;
+      return states_;
+    }
+
+   private:
+    constexpr bool AtEnd() const {
+      return pos_ == pattern_.size();
+    }
+
+    constexpr char Peek() const {
+      return pattern_[pos_];
+    }
+
+    constexpr int NewState() {
+      states_.push_back({});
+      return static_cast<int>(states_.size()) - 1;
+    }
+
+    constexpr void Epsilon(int from, int to) {
+      auto& epsilon = states_[from].epsilon;
+      (epsilon[0] < 0 ? epsilon[0] : epsilon[1]) = to;
+    }
+
+    constexpr RegexFragment Empty() {
+      int state = NewState();
+      return {state, state};
+    }
+
+    constexpr RegexFragment Set(const RegexCharSet& set) {
+      int start = NewState();
+      int end = NewState();
+      states_[start].consumes = true;
+      states_[start].set = set;
+      states_[start].next = end;
+      return {start, end};
+    }
+
+    constexpr RegexFragment Concat(RegexFragment a, RegexFragment b) {
+      Epsilon(a.end, b.start);
+      return {a.start, b.end};
+    }
+
+    constexpr RegexFragment Alternate(RegexFragment a, RegexFragment b) {
+      int start = NewState();
+      int end = NewState();
+      Epsilon(start, a.start);
+      Epsilon(start, b.start);
+      Epsilon(a.end, end);
+      Epsilon(b.end, end);
+      return {start, end};
+    }
+
+    constexpr RegexFragment Star(RegexFragment a) {
+      int start = NewState();
+      int end = NewState();
+      Epsilon(start, a.start);
+      Epsilon(start, end);
+      Epsilon(a.end, a.start);
+      Epsilon(a.end, end);
+      return {start, end};
+    }
+
+    constexpr RegexFragment Plus(RegexFragment a) {
+      int end = NewState();
+      Epsilon(a.end, a.start);
+      Epsilon(a.end, end);
+      return {a.start, end};
+    }
+
+    constexpr RegexFragment Optional(RegexFragment a) {
+      int start = NewState();
+      int end = NewState();
+      Epsilon(start, a.start);
+      Epsilon(start, end);
+      Epsilon(a.end, end);
+      return {start, end};
+    }
+
+    constexpr RegexFragment ParseAlternation() {
+      RegexFragment fragment = ParseConcatenation();
+      while (!AtEnd() && Peek() == '|') {
+        ++pos_;
+        fragment = Alternate(fragment, ParseConcatenation());
+      }
+      return fragment;
+    }
+
+    constexpr RegexFragment ParseConcatenation() {
+      std::optional<RegexFragment> fragment;
+      while (!AtEnd() && Peek() != '|' && Peek() != ')') {
+        RegexFragment next = ParseRepeat();
+        fragment = fragment ? Concat(*fragment, next) : next;
+      }
+      return fragment ? *fragment : Empty();
+    }
+
+    constexpr std::size_t ParseNumber() {
+      if (AtEnd() || Peek() < '0' || Peek() > '9') {
+        RegexError("regex: expected a number in {}");
+      }
+      std::size_t number = 0;
+      while (!AtEnd() && Peek() >= '0' && Peek() <= '9') {
+        number = number * 10 + static_cast<std::size_t>(Peek() - '0');
+        ++pos_;
+      }
+      return number;
+    }
+
+    // Parses the atom at begin again, leaving pos_ where it was
+    constexpr RegexFragment CopyAtom(std::size_t begin) {
+      std::size_t saved = pos_;
+      pos_ = begin;
+      RegexFragment copy = ParseAtom();
+      pos_ = saved;
+      return copy;
+    }
+
+    constexpr RegexFragment ParseRepeat() {
+      std::size_t begin = pos_;
+      RegexFragment atom = ParseAtom();
+      if (AtEnd()) {
+        return atom;
+      }
+      switch (Peek()) {
+        case '*':
+          ++pos_;
+          atom = Star(atom);
+          break;
+        case '+':
+          ++pos_;
+          atom = Plus(atom);
+          break;
+        case '?':
+          ++pos_;
+          atom = Optional(atom);
+          break;
+        case '{': {
+          ++pos_;
+          std::size_t min = ParseNumber();
+          std::size_t max = min;
+          bool unbounded = false;
+          if (!AtEnd() && Peek() == ',') {
+            ++pos_;
+            if (!AtEnd() && Peek() == '}') {
+              unbounded = true;
+            } else {
+              max = ParseNumber();
+            }
+          }
+          if (AtEnd() || Peek() != '}' || max < min) {
+            RegexError("regex: malformed {m,n}");
+          }
+          ++pos_;
+          std::optional<RegexFragment> repeated;
+          auto append = [&](RegexFragment next) {
+            repeated = repeated ? Concat(*repeated, next) : next;
+          };
+          for (std::size_t i = 0; i < min; ++i) {
+            append(i == 0 ? atom : CopyAtom(begin));
+          }
+          if (unbounded) {
+            append(Star(min == 0 ? atom : CopyAtom(begin)));
+          }
+          for (std::size_t i = min; i < max; ++i) {
+            append(Optional(i == 0 ? atom : CopyAtom(begin)));
+          }
+          atom = repeated ? *repeated : Empty();
+          break;
+        }
+        default:
+          return atom;
+      }
+      if (!AtEnd() && (Peek() == '*' || Peek() == '+' || Peek() == '?' || Peek() == '{')) {
+        RegexError("regex: quantifier follows a quantifier");
+      }
+      return atom;
+    }
+
+    constexpr RegexCharSet ParseEscape() {
+      if (AtEnd()) {
+        RegexError("regex: trailing backslash");
+      }
+      char c = pattern_[pos_++];
+      RegexCharSet set;
+      switch (c) {
+        case 'd': case 'D':
+          set.AddRange('0', '9');
+          break;
+        case 'w': case 'W':
+          set.AddRange('a', 'z');
+          set.AddRange('A', 'Z');
+          set.AddRange('0', '9');
+          set.Add('_');
+          break;
+        case 's': case 'S':
+          for (char space : {' ', '\t', '\n', '\r', '\f', '\v'}) {
+            set.Add(static_cast<unsigned char>(space));
+          }
+          break;
+        case 't':
+          set.Add('\t');
+          break;
+        case 'n':
+          set.Add('\n');
+          break;
+        case 'r':
+          set.Add('\r');
+          break;
+        default:
+          set.Add(static_cast<unsigned char>(c));
+          return set;
+      }
+      if (c == 'D' || c == 'W' || c == 'S') {
+        set.Invert();
+      }
+      return set;
+    }
+
+    constexpr RegexCharSet ParseClass() {
+      RegexCharSet set;
+      bool negated = !AtEnd() && Peek() == '^';
+      if (negated) {
+        ++pos_;
+      }
+      bool first = true;
+      while (!AtEnd() && (Peek() != ']' || first)) {
+        first = false;
+        char c = pattern_[pos_++];
+        if (c == '\\') {
+          set |= ParseEscape();
+        } else if (pos_ + 1 < pattern_.size() && Peek() == '-' && pattern_[pos_ + 1] != ']') {
+          char hi = pattern_[pos_ + 1];
+          pos_ += 2;
+          if (static_cast<unsigned char>(hi) < static_cast<unsigned char>(c)) {
+            RegexError("regex: reversed range in []");
+          }
+          set.AddRange(static_cast<unsigned char>(c), static_cast<unsigned char>(hi));
+        } else {
+          set.Add(static_cast<unsigned char>(c));
+        }
+      }
+      if (AtEnd()) {
+        RegexError("regex: unterminated [");
+      }
+      ++pos_;
+      if (negated) {
+        set.Invert();
+      }
+      return set;
+    }
+
+    constexpr RegexFragment ParseAtom() {
+      if (AtEnd()) {
+        RegexError("regex: expected an atom");
+      }
+      char c = pattern_[pos_++];
+      RegexCharSet set;
+      switch (c) {
+        case '(': {
+          RegexFragment group = ParseAlternation();
+          if (AtEnd() || Peek() != ')') {
+            RegexError("regex: unbalanced '('");
+          }
+          ++pos_;
+          return group;
+        }
+        case '[':
+          return Set(ParseClass());
+        case '.':
+          set.Add('\n');
+          set.Invert();
+          return Set(set);
+        case '\\':
+          return Set(ParseEscape());
+        case '*': case '+': case '?': case '{':
+          RegexError("regex: nothing to repeat");
+          return Empty();
+        default:
+          set.Add(static_cast<unsigned char>(c));
+          return Set(set);
+      }
+    }
+
+    std::string_view pattern_;
+    std::size_t pos_ = 0;
+    std::vector<RegexNfaState> states_;
+  };
+
+  inline constexpr std::size_t kRegexMaxPrefix = 32;
+
+  // State 0 is the dead state, state 1 the start state of Match and state 2
+  // the start state of Search. Search states run an anchored attempt from
+  // every position at once: a state is the set of NFA states of the
+  // attempts still live, and each step also starts a fresh attempt. With no
+  // attempt live the set is empty, so state 2 is also the only state where
+  // no match can have begun yet.
+  struct RegexDfaBuild {
+    std::array<std::uint8_t, 256> byte_class{};
+    std::size_t num_classes = 0;
+    std::vector<int> next;
+    std::vector<bool> accepting;
+    std::string_view::size_type prefix_size = 0;
+    std::array<char, kRegexMaxPrefix> prefix{};
+
+    constexpr std::size_t NumStates() const {
+      return accepting.size();
+    }
+
+    constexpr int Step(int state, unsigned char c) const {
+      return next[static_cast<std::size_t>(state) * num_classes + byte_class[c]];
+    }
+  };
+
+  constexpr RegexDfaBuild BuildRegexDfa(std::string_view pattern) {
+    int start = 0;
+    int accept = 0;
+    std::vector<RegexNfaState> nfa = RegexParser(pattern).Parse(start, accept);
+
+    // Bytes no set tells apart share a class, so the table has one column
+    // per class instead of 256
+    RegexDfaBuild dfa;
+    std::size_t classes = 1;
+    std::vector<RegexCharSet> seen;
+    for (const auto& state : nfa) {
+      if (!state.consumes) {
+        continue;
+      }
+      bool repeated = false;
+      for (const auto& set : seen) {
+        repeated = repeated || set.words == state.set.words;
+      }
+      if (repeated) {
+        continue;
+      }
+      seen.push_back(state.set);
+      std::array<int, 512> renamed{};
+      int count = 0;
+      for (unsigned c = 0; c < 256; ++c) {
+        auto& name = renamed[dfa.byte_class[c] * 2 + state.set.Contains(static_cast<unsigned char>(c))];
+        if (name == 0) {
+          name = ++count;
+        }
+        dfa.byte_class[c] = static_cast<std::uint8_t>(name - 1);
+      }
+      classes = static_cast<std::size_t>(count);
+    }
+    dfa.num_classes = classes;
+    std::vector<unsigned char> representative(classes);
+    for (unsigned c = 256; c-- > 0;) {
+      representative[dfa.byte_class[c]] = static_cast<unsigned char>(c);
+    }
+
+    // Subset construction over bitsets of NFA states. Only set bits are
+    // visited, and subsets are compared only when their hashes agree, which
+    // keeps constant evaluation well inside the compiler's operation limit.
+    std::size_t words = (nfa.size() + 63) / 64;
+    using Subset = std::vector<std::uint64_t>;
+    auto insert = [](Subset& subset, int state) {
+      auto& word = subset[static_cast<std::size_t>(state) / 64];
+      auto bit = std::uint64_t{1} << (state % 64);
+      bool added = (word & bit) == 0;
+      word |= bit;
+      return added;
+    };
+    auto for_each = [words](const Subset& subset, auto&& visit) {
+      for (std::size_t w = 0; w < words; ++w) {
+        for (std::uint64_t bits = subset[w]; bits != 0; bits &= bits - 1) {
+          visit(static_cast<int>(w * 64 + static_cast<std::size_t>(std::countr_zero(bits))));
+        }
+      }
+    };
+    auto close = [&](Subset& subset) {
+      std::vector<int> stack;
+      for_each(subset, [&](int state) {
+        stack.push_back(state);
+      });
+      while (!stack.empty()) {
+        int state = stack.back();
+        stack.pop_back();
+        for (int target : nfa[static_cast<std::size_t>(state)].epsilon) {
+          if (target >= 0 && insert(subset, target)) {
+            stack.push_back(target);
+          }
+        }
+      }
+    };
+    auto hash = [](const Subset& subset, bool searching) {
+      std::uint64_t h = searching;
+      for (auto word : subset) {
+        h = (h ^ word) * 0x9e3779b97f4a7c15;
+      }
+      return h;
+    };
+
+    // A Search state keeps the subset of its live attempts and steps it
+    // together with the start subset of the fresh one
+    std::vector<Subset> subsets;
+    std::vector<bool> searching;
+    std::vector<std::uint64_t> hashes;
+    auto intern = [&](const Subset& subset, bool search) {
+      std::uint64_t h = hash(subset, search);
+      for (std::size_t i = 0; i < subsets.size(); ++i) {
+        if (hashes[i] == h && searching[i] == search && subsets[i] == subset) {
+          return i;
+        }
+      }
+      subsets.push_back(subset);
+      searching.push_back(search);
+      hashes.push_back(h);
+      return subsets.size() - 1;
+    };
+    Subset initial(words, 0);
+    insert(initial, start);
+    close(initial);
+    // Closure of where each consuming state goes, so that a transition is a
+    // union of these instead of a closure of its own
+    std::vector<Subset> after(nfa.size());
+    for (std::size_t s = 0; s < nfa.size(); ++s) {
+      if (nfa[s].consumes) {
+        after[s].assign(words, 0);
+        insert(after[s], nfa[s].next);
+        close(after[s]);
+      }
+    }
+    intern(Subset(words, 0), false);
+    intern(initial, false);
+    intern(Subset(words, 0), true);
+    for (std::size_t i = 0; i < subsets.size(); ++i) {
+      Subset from = subsets[i];
+      if (searching[i]) {
+        for (std::size_t w = 0; w < words; ++w) {
+          from[w] |= initial[w];
+        }
+      }
+      std::vector<Subset> targets(classes, Subset(words, 0));
+      for_each(from, [&](int s) {
+        const auto& state = nfa[static_cast<std::size_t>(s)];
+        if (!state.consumes) {
+          return;
+        }
+        for (std::size_t k = 0; k < classes; ++k) {
+          if (state.set.Contains(representative[k])) {
+            for (std::size_t w = 0; w < words; ++w) {
+              targets[k][w] |= after[static_cast<std::size_t>(s)][w];
+            }
+          }
+        }
+      });
+      dfa.accepting.push_back((subsets[i][static_cast<std::size_t>(accept) / 64] >> (accept % 64) & 1) != 0);
+      bool search = searching[i];
+      for (const auto& target : targets) {
+        dfa.next.push_back(static_cast<int>(intern(target, search)));
+      }
+    }
+
+    // Bytes every match starts with, for a fast scan in Search
+    std::vector<int> class_size(classes);
+    for (unsigned c = 0; c < 256; ++c) {
+      ++class_size[dfa.byte_class[c]];
+    }
+    int state = 1;
+    while (dfa.prefix_size < kRegexMaxPrefix && !dfa.accepting[static_cast<std::size_t>(state)]) {
+      std::size_t only = classes;
+      int live = 0;
+      for (std::size_t k = 0; k < classes; ++k) {
+        if (dfa.next[static_cast<std::size_t>(state) * classes + k] != 0) {
+          only = k;
+          live += class_size[k];
+        }
+      }
+      if (live != 1) {
+        break;
+      }
+      dfa.prefix[dfa.prefix_size++] = static_cast<char>(representative[only]);
+      state = dfa.next[static_cast<std::size_t>(state) * classes + only];
+    }
+    return dfa;
+  }
+
+  inline constexpr std::size_t kRegexMaxTable = 65536;
+
+  // BuildRegexDfa copied out of its vectors, which cannot outlive constant
+  // evaluation, into arrays big enough for any DFA RegexDfa accepts
+  struct RegexDfaTable {
+    std::array<std::uint8_t, 256> byte_class{};
+    std::size_t num_states = 0;
+    std::size_t num_classes = 0;
+    std::size_t prefix_size = 0;
+    std::array<char, kRegexMaxPrefix> prefix{};
+    std::array<std::uint16_t, kRegexMaxTable> next{};
+    std::array<bool, kRegexMaxTable> accepting{};
+  };
+
+  // Runs the subset construction once per pattern; kRegexDfa takes both
+  // its shape and its contents from here
+  template
+    < FixedString<256> pattern
+    >
+  inline constexpr auto kRegexTable = [] {
+    auto built = BuildRegexDfa(pattern);
+    RegexDfaTable table;
+    table.byte_class = built.byte_class;
+    table.num_states = built.NumStates();
+    table.num_classes = built.num_classes;
+    table.prefix_size = built.prefix_size;
+    table.prefix = built.prefix;
+    if (built.next.size() <= kRegexMaxTable) {
+      for (std::size_t i = 0; i < built.next.size(); ++i) {
+        table.next[i] = static_cast<std::uint16_t>(built.next[i]);
+      }
+      for (std::size_t i = 0; i < built.NumStates(); ++i) {
+        table.accepting[i] = built.accepting[i];
+      }
+    }
+    return table;
+  }();
+
+  template
+    < std::size_t states
+    , std::size_t classes
+    , std::size_t prefix_size
+    >
+  struct RegexDfa {
+    static_assert(states * classes <= kRegexMaxTable, "regex needs too many DFA states");
+
+    // A state is its row offset in next, so a step is two loads and an add
+    using State = std::conditional_t<(states * classes <= 256), std::uint8_t, std::uint16_t>;
+    static constexpr State kDead = 0;
+    static constexpr State kStart = classes;
+    static constexpr State kSearch = 2 * classes;
+    static constexpr std::size_t kStates = states;
+
+    std::array<std::uint8_t, 256> byte_class{};
+    std::array<State, states * classes> next{};
+    std::array<bool, states> accepting{};
+    std::array<bool, 256> starts{};  // bytes with a transition out of the start state
+    std::array<char, prefix_size> prefix{};
+
+    constexpr State Step(State state, char c) const {
+      return next[state + byte_class[static_cast<unsigned char>(c)]];
+    }
+
+    constexpr bool Accepting(State state) const {
+      return accepting[state / classes];
+    }
+  };
+
+  template
+    < FixedString<256> pattern
+    >
+  inline constexpr auto kRegexDfa = [] {
+    constexpr auto& table = kRegexTable<pattern>;
+    constexpr std::size_t classes = table.num_classes;
+    RegexDfa<table.num_states, classes, table.prefix_size> dfa;
+    using State = typename decltype(dfa)::State;
+    dfa.byte_class = table.byte_class;
+    for (std::size_t i = 0; i < dfa.next.size(); ++i) {
+      dfa.next[i] = static_cast<State>(table.next[i] * classes);
+    }
+    for (std::size_t i = 0; i < dfa.accepting.size(); ++i) {
+      dfa.accepting[i] = table.accepting[i];
+    }
+    for (unsigned c = 0; c < 256; ++c) {
+      dfa.starts[c] = table.next[classes + table.byte_class[c]] != 0;
+    }
+    for (std::size_t i = 0; i < dfa.prefix.size(); ++i) {
+      dfa.prefix[i] = table.prefix[i];
+    }
+    return dfa;
+  }();
+
+  // One pass of the Search states up to the end of the earliest match.
+  // Returns the last position where no attempt was live: every match that
+  // has not ended before it begins at or after it. Bytes that cannot begin
+  // a match are skipped with string_view::find on the literal prefix every
+  // match begins with, or with the table of bytes that leave the start state.
+  template
+    < FixedString<256> pattern
+    >
+  constexpr std::optional<std::size_t> RegexFindMatchRegion(std::string_view text) {
+    constexpr auto& dfa = kRegexDfa<pattern>;
+    std::size_t region = 0;
+    auto state = dfa.kSearch;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+      if (state == dfa.kSearch) {
+        if constexpr (dfa.prefix.size() != 0) {
+          i = text.find(std::string_view(dfa.prefix.data(), dfa.prefix.size()), i);
+          if (i == std::string_view::npos) {
+            return std::nullopt;
+          }
+        } else {
+          while (i < text.size() && !dfa.starts[static_cast<unsigned char>(text[i])]) {
+            ++i;
+          }
+          if (i == text.size()) {
+            return std::nullopt;
+          }
+        }
+        region = i;
+      }
+      state = dfa.Step(state, text[i]);
+      if (dfa.Accepting(state)) {
+        return region;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // The leftmost-longest match beginning at or after from, which must
+  // exist. Runs one anchored attempt per start position, in order of start;
+  // two attempts in the same state see the same text from then on, so the
+  // later one is dropped and at most one attempt per state is live. No
+  // attempt starts after the first match is found.
+  template
+    < FixedString<256> pattern
+    >
+  constexpr std::string_view RegexLeftmostLongest(std::string_view text, std::size_t from) {
+    constexpr auto& dfa = kRegexDfa<pattern>;
+    using State = typename std::remove_cvref_t<decltype(dfa)>::State;
+    std::array<State, dfa.kStates> states;
+    std::array<std::size_t, dfa.kStates> begins;
+    std::size_t live = 0;
+    std::size_t best_begin = std::string_view::npos;
+    std::size_t best_end = 0;
+    auto found = [&](std::size_t begin, std::size_t end) {
+      if (begin <= best_begin) {
+        best_begin = begin;
+        best_end = end;
+      }
+    };
+    for (std::size_t i = from;; ++i) {
+      if (best_begin == std::string_view::npos) {
+        bool merged = false;
+        for (std::size_t r = 0; r < live; ++r) {
+          merged = merged || states[r] == dfa.kStart;
+        }
+        // Live attempts are in distinct states other than kDead, so there
+        // is always room; the bound only spells that out for the compiler
+        if (!merged && live < states.size()) {
+          states[live] = dfa.kStart;
+          begins[live] = i;
+          ++live;
+          if (dfa.Accepting(dfa.kStart)) {
+            found(i, i);
+          }
+        }
+      }
+      if (live == 0 || i == text.size()) {
+        break;
+      }
+      std::size_t kept = 0;
+      for (std::size_t r = 0; r < live; ++r) {
+        State next = dfa.Step(states[r], text[i]);
+        if (next == dfa.kDead || begins[r] > best_begin) {
+          continue;
+        }
+        bool merged = false;
+        for (std::size_t k = 0; k < kept; ++k) {
+          merged = merged || states[k] == next;
+        }
+        if (merged) {
+          continue;
+        }
+        states[kept] = next;
+        begins[kept] = begins[r];
+        ++kept;
+        if (dfa.Accepting(next)) {
+          found(begins[r], i + 1);
+        }
+      }
+      live = kept;
+    }
+    return text.substr(best_begin, best_end - best_begin);
+  }
+}
+
+
+// Whether all of text matches pattern
+template
+  < FixedString<256> pattern
+  >
+constexpr bool Match(std::string_view text) {
+  constexpr auto& dfa = detail::kRegexDfa<pattern>;
+  auto state = dfa.kStart;
+  for (char c : text) {
+    state = dfa.Step(state, c);
+    if (state == dfa.kDead) {
+      return false;
+    }
+  }
+  return dfa.Accepting(state);
+}
+
+// The leftmost, then longest, substring of text matching pattern, found
+// in time linear in the size of text: one DFA pass finds the region the
+// match lies in, and a second one over that region picks its bounds.
+template
+  < FixedString<256> pattern
+  >
+constexpr std::optional<std::string_view> Search(std::string_view text) {
+  constexpr auto& dfa = detail::kRegexDfa<pattern>;
+  std::size_t from = 0;
+  if constexpr (!dfa.Accepting(dfa.kStart)) {
+    auto region = detail::RegexFindMatchRegion<pattern>(text);
+    if (!region) {
+      return std::nullopt;
+    }
+    from = *region;
+  }
+  return detail::RegexLeftmostLongest<pattern>(text, from);
+}
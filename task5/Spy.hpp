@@ -1,10 +1,97 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <compare>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <source_location>
 #include <type_traits>
+#include <utility>
+
+#include "ThreadShards.hpp"
+
+
+// Sink of Spy::Trace() events, defined by SpyProfiler.hpp: only code that
+// calls Trace() includes it and pays for its headers
+class SpyProfiler;
+
+
+// Threading modes of Spy
+struct SingleThreaded {};
+struct Concurrent {};
 
 
+namespace detail {
+  inline std::uint64_t SpyClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+}
+
+
+// Sampling policies of Spy: Sample() is asked at the start of every
+// expression whether the logger should see it
+
+struct AlwaysSample {
+  static constexpr bool Sample() noexcept {
+    return true;
+  }
+};
+
+template <unsigned int N>
+  requires (N > 0)
+class SampleEveryNth {
+ public:
+  bool Sample() noexcept {
+    auto left = countdown_.load(std::memory_order_relaxed);
+    if (left != 0) {
+      countdown_.store(left - 1, std::memory_order_relaxed);
+      return false;
+    }
+    countdown_.store(N - 1, std::memory_order_relaxed);
+    return true;
+  }
+
+ private:
+  std::atomic<unsigned int> countdown_{0};
+};
+
+template <double probability>
+  requires (probability >= 0.0 && probability <= 1.0)
+struct SampleWithProbability {
+  static bool Sample() noexcept {
+    thread_local std::uint64_t state = reinterpret_cast<std::uintptr_t>(&state) | 1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return (state >> 32) < kThreshold;
+  }
+
+ private:
+  static constexpr std::uint64_t kThreshold = static_cast<std::uint64_t>(probability * 4294967296.0);
+};
+
+// At most one expression per period; reads the clock on every expression start
+template <std::uint64_t period_ns>
+class SamplePeriodically {
+ public:
+  bool Sample() noexcept {
+    auto now = detail::SpyClockNs();
+    if (now < next_ns_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    next_ns_.store(now + period_ns, std::memory_order_relaxed);
+    return true;
+  }
+
+ private:
+  std::atomic<std::uint64_t> next_ns_{0};
+};
+
 namespace detail {
   struct ILoggerHolder {
     virtual ILoggerHolder* MakeCopy() = 0;
@@ -32,11 +119,109 @@ namespace detail {
 
     ~LoggerHolder() override = default;
   };
+
+  template <class Threading>
+  struct SpyCounters;
+
+  // Plain counters, the default: nothing but two increments per operator->.
+  // Whether an expression is tracked is decided once, by its first operator->
+  template <>
+  struct SpyCounters<SingleThreaded> {
+    template <class Sampling>
+    void Enter(Sampling& sampler) {
+      if (wrapper_cnt_++ == 0) {
+        tracked_ = sampler.Sample();
+      }
+      calls_cnt_ += tracked_;
+    }
+
+    // Calls on_last(calls) when the last live wrapper of a tracked expression ends
+    template <typename F>
+    void Leave(F&& on_last) {
+      if (--wrapper_cnt_ == 0 && tracked_) {
+        on_last(calls_cnt_);
+        calls_cnt_ = 0;
+      }
+    }
+
+   private:
+    unsigned int calls_cnt_ = 0;
+    unsigned int wrapper_cnt_ = 0;
+    bool tracked_ = true;
+  };
+
+  // Calls are counted in per-thread cache-line padded shards and summed up
+  // when the last live wrapper ends. Every call is reported exactly once,
+  // though a call racing with that moment may land in the neighbouring report.
+  // The tracked bit shares one word with the wrapper count and only changes
+  // while the count is 0, so every wrapper of an expression sees the decision
+  // of its first one, and the last one sees it too.
+  template <>
+  struct SpyCounters<Concurrent> {
+    template <class Sampling>
+    void Enter(Sampling& sampler) {
+      unsigned int state = state_.load(std::memory_order_relaxed);
+      int sampled = -1;
+      while (true) {
+        if (state >= kOneWrapper) {
+          // Joins the live expression with one fetch_add. Should it have
+          // ended since the load, this wrapper starts the next expression
+          // under the decision of the last one, which the other wrappers
+          // see too since the bit stays put
+          state = state_.fetch_add(kOneWrapper, std::memory_order_relaxed);
+          break;
+        }
+        // The first wrapper decides; a CAS, so that a wrapper that joined
+        // in the meantime keeps the decision it saw
+        if (sampled < 0) {
+          sampled = sampler.Sample();
+        }
+        if (state_.compare_exchange_weak(state, kOneWrapper | static_cast<unsigned int>(sampled),
+                                         std::memory_order_relaxed)) {
+          state = static_cast<unsigned int>(sampled);
+          break;
+        }
+      }
+      if (state & kTracked) {
+        calls_[ThisThreadShard()].value.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    template <typename F>
+    void Leave(F&& on_last) {
+      if (state_.fetch_sub(kOneWrapper, std::memory_order_acq_rel) == (kOneWrapper | kTracked)) {
+        // Most shards are untouched: reading them first keeps the drain to
+        // plain loads instead of one read-modify-write per shard
+        unsigned int calls = 0;
+        for (auto& shard : calls_) {
+          if (shard.value.load(std::memory_order_relaxed) != 0) {
+            calls += shard.value.exchange(0, std::memory_order_relaxed);
+          }
+        }
+        std::lock_guard lock(log_mutex_);
+        on_last(calls);
+      }
+    }
+
+   private:
+    static constexpr unsigned int kTracked = 1;
+    static constexpr unsigned int kOneWrapper = 2;
+
+    struct alignas(kCacheLine) Shard {
+      std::atomic<unsigned int> value{0};
+    };
+
+    std::array<Shard, kSpyShards> calls_;
+    // Live wrappers times kOneWrapper, plus kTracked
+    alignas(kCacheLine) std::atomic<unsigned int> state_{0};
+    std::mutex log_mutex_;
+  };
 }
 
-template <class T>
+template <class T, class Threading = SingleThreaded, class Sampling = AlwaysSample>
 class Spy {
   class SpyWrapper {
+   protected:
     Spy& spy_;
    public:
     SpyWrapper(Spy& spy) : spy_(spy) {}
@@ -46,12 +231,33 @@ class Spy {
     }
 
     ~SpyWrapper() {
-      if (--spy_.wrapper_cnt_ == 0) {
+      spy_.counters_.Leave([this](unsigned int calls) {
         if (spy_.logger_) {
-          spy_.logger_->Log(spy_.calls_cnt_);
+          spy_.logger_->Log(calls);
         }
-        spy_.calls_cnt_ = 0;
-      }
+      });
+    }
+  };
+
+  template <class Profiler>
+  class ProfiledWrapper : public SpyWrapper {
+    std::source_location site_;
+    const char* member_;
+    std::uint64_t start_ns_;
+   public:
+    ProfiledWrapper(Spy& spy, std::source_location site, const char* member)
+      : SpyWrapper(spy), site_(site), member_(member), start_ns_(detail::SpyClockNs()) {}
+
+    ~ProfiledWrapper() {
+      Profiler::Record(typename Profiler::Event{
+        .spy = &this->spy_,
+        .file = site_.file_name(),
+        .function = site_.function_name(),
+        .member = member_,
+        .line = site_.line(),
+        .start_ns = start_ns_,
+        .duration_ns = detail::SpyClockNs() - start_ns_,
+      });
     }
   };
 public:
@@ -100,11 +306,19 @@ public:
   }
 
   SpyWrapper operator->() {
-    ++calls_cnt_;
-    ++wrapper_cnt_;
+    counters_.Enter(sampler_);
     return SpyWrapper(*this);
   }
 
+  // operator-> that also reports the wrapper lifetime and call site to
+  // SpyProfiler: spy.Trace("field")->field. Needs SpyProfiler.hpp
+  template <class Profiler = SpyProfiler>
+  ProfiledWrapper<Profiler> Trace(const char* member = nullptr,
+                                  std::source_location site = std::source_location::current()) {
+    counters_.Enter(sampler_);
+    return ProfiledWrapper<Profiler>(*this, site, member);
+  }
+
   // Resets logger
   void setLogger() {
     logger_.reset();
@@ -122,6 +336,6 @@ public:
 private:
   T value_;
   std::unique_ptr<detail::ILoggerHolder> logger_;
-  unsigned int calls_cnt_ = 0;
-  unsigned int wrapper_cnt_ = 0;
+  detail::SpyCounters<Threading> counters_;
+  [[no_unique_address]] Sampling sampler_;
 };
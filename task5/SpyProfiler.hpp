@@ -0,0 +1,292 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <compare>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Spy.hpp"
+
+
+// One SpyWrapper lifetime, from operator-> to the end of the full expression
+struct SpyEvent {
+  const void* spy = nullptr;
+  const char* file = "";
+  const char* function = "";
+  const char* member = nullptr;
+  std::uint32_t line = 0;
+  std::uint32_t thread = 0;
+  std::uint64_t start_ns = 0;
+  std::uint64_t duration_ns = 0;
+};
+
+namespace detail {
+  // By text, a missing member first: equal literals of different
+  // translation units or inline copies need not share an address
+  inline std::strong_ordering CompareSpyText(const char* lhs, const char* rhs) {
+    if (!lhs || !rhs) {
+      return (lhs != nullptr) <=> (rhs != nullptr);
+    }
+    return std::string_view(lhs) <=> std::string_view(rhs);
+  }
+}
+
+struct SpySite {
+  const void* spy;
+  const char* file;
+  std::uint32_t line;
+  const char* member;
+
+  std::strong_ordering operator<=>(const SpySite& other) const {
+    if (auto order = std::compare_three_way{}(spy, other.spy); order != 0) {
+      return order;
+    }
+    if (auto order = detail::CompareSpyText(file, other.file); order != 0) {
+      return order;
+    }
+    if (auto order = line <=> other.line; order != 0) {
+      return order;
+    }
+    return detail::CompareSpyText(member, other.member);
+  }
+
+  bool operator==(const SpySite& other) const {
+    return (*this <=> other) == 0;
+  }
+};
+
+// Histogram bucket i holds lifetimes in [2^(i-1), 2^i) ns
+struct SpySiteStats {
+  std::uint64_t calls = 0;
+  std::array<std::uint64_t, 64> histogram{};
+};
+
+enum class SpyTraceFormat {
+  ChromeJson,
+  Binary,
+};
+
+
+namespace detail {
+  // Written only by its owning thread, read only under the registry lock
+  struct SpyRingBuffer {
+    static constexpr std::size_t kCapacity = 4096;
+
+    explicit SpyRingBuffer(std::uint32_t thread) : thread(thread) {}
+
+    bool Push(const SpyEvent& event) noexcept {
+      auto head = head_.load(std::memory_order_relaxed);
+      if (head - tail_.load(std::memory_order_acquire) == kCapacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      events_[head % kCapacity] = event;
+      events_[head % kCapacity].thread = thread;
+      head_.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    template <typename F>
+    void Drain(F&& consumer) {
+      auto tail = tail_.load(std::memory_order_relaxed);
+      auto head = head_.load(std::memory_order_acquire);
+      for (; tail != head; ++tail) {
+        consumer(events_[tail % kCapacity]);
+      }
+      tail_.store(tail, std::memory_order_release);
+    }
+
+    bool Empty() const {
+      return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    const std::uint32_t thread;
+    std::atomic<std::uint64_t> dropped{0};
+
+   private:
+    std::array<SpyEvent, kCapacity> events_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+  };
+
+  inline void WriteJsonString(std::ostream& out, std::string_view str) {
+    out << '"';
+    for (char c : str) {
+      if (c == '"' || c == '\\') {
+        out << '\\' << c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        char escaped[7];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        out << escaped;
+      } else {
+        out << c;
+      }
+    }
+    out << '"';
+  }
+
+  template <class U>
+  void WriteRaw(std::ostream& out, U value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  inline void WriteRawString(std::ostream& out, std::string_view str) {
+    WriteRaw(out, static_cast<std::uint16_t>(str.size()));
+    out.write(str.data(), static_cast<std::streamsize>(static_cast<std::uint16_t>(str.size())));
+  }
+}
+
+
+// Process-wide sink of Spy::Trace() events; including this header is what
+// enables Trace(). Recording touches only the calling thread's ring buffer;
+// a full buffer drops the event and counts it.
+class SpyProfiler {
+ public:
+  using Event = SpyEvent;
+
+  static void Record(const SpyEvent& event) noexcept {
+    LocalBuffer().Push(event);
+  }
+
+  // Drains all buffers into the statistics and writes the drained events
+  static void Flush(std::ostream& out, SpyTraceFormat format = SpyTraceFormat::ChromeJson) {
+    auto events = Drain();
+    if (format == SpyTraceFormat::ChromeJson) {
+      WriteChromeTrace(out, events);
+    } else {
+      WriteBinary(out, events);
+    }
+  }
+
+  // Drains all buffers into the statistics, discarding the events
+  static void Collect() {
+    Drain();
+  }
+
+  static std::map<SpySite, SpySiteStats> Statistics() {
+    std::lock_guard lock(State().mutex);
+    return State().stats;
+  }
+
+  static std::uint64_t Dropped() {
+    std::lock_guard lock(State().mutex);
+    std::uint64_t dropped = 0;
+    for (const auto& buffer : State().buffers) {
+      dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+  }
+
+  static void Reset() {
+    Drain();
+    std::lock_guard lock(State().mutex);
+    State().stats.clear();
+    for (const auto& buffer : State().buffers) {
+      buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<detail::SpyRingBuffer>> buffers;
+    std::map<SpySite, SpySiteStats> stats;
+    std::uint32_t next_thread = 0;
+  };
+
+  static Registry& State() {
+    static Registry registry;
+    return registry;
+  }
+
+  static detail::SpyRingBuffer& LocalBuffer() {
+    thread_local std::shared_ptr<detail::SpyRingBuffer> buffer = [] {
+      std::lock_guard lock(State().mutex);
+      auto created = std::make_shared<detail::SpyRingBuffer>(State().next_thread++);
+      State().buffers.push_back(created);
+      return created;
+    }();
+    return *buffer;
+  }
+
+  static std::size_t Bucket(std::uint64_t duration_ns) {
+    std::size_t bucket = 0;
+    while (duration_ns != 0 && bucket + 1 < 64) {
+      duration_ns >>= 1;
+      ++bucket;
+    }
+    return bucket;
+  }
+
+  static std::vector<SpyEvent> Drain() {
+    std::vector<SpyEvent> events;
+    std::lock_guard lock(State().mutex);
+    auto& buffers = State().buffers;
+    for (const auto& buffer : buffers) {
+      buffer->Drain([&events](const SpyEvent& event) {
+        events.push_back(event);
+      });
+    }
+    // Buffers of finished threads are owned by the registry alone
+    std::erase_if(buffers, [](const auto& buffer) {
+      return buffer.use_count() == 1 && buffer->Empty() && buffer->dropped.load() == 0;
+    });
+    for (const auto& event : events) {
+      auto& stats = State().stats[SpySite{event.spy, event.file, event.line, event.member}];
+      ++stats.calls;
+      ++stats.histogram[Bucket(event.duration_ns)];
+    }
+    return events;
+  }
+
+  static void WriteChromeTrace(std::ostream& out, const std::vector<SpyEvent>& events) {
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& event : events) {
+      out << (first ? "\n" : ",\n");
+      first = false;
+      char site[32];
+      std::snprintf(site, sizeof(site), ":%u", static_cast<unsigned>(event.line));
+      std::string name = std::string(event.file) + site;
+      if (event.member) {
+        name = name + " " + event.member;
+      }
+      char spy[32];
+      std::snprintf(spy, sizeof(spy), "%p", event.spy);
+      out << "{\"name\":";
+      detail::WriteJsonString(out, name);
+      out << ",\"cat\":\"spy\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+          << ",\"ts\":" << event.start_ns / 1000 << '.' << event.start_ns % 1000 / 100
+          << ",\"dur\":" << event.duration_ns / 1000 << '.' << event.duration_ns % 1000 / 100
+          << ",\"args\":{\"spy\":\"" << spy << "\",\"function\":";
+      detail::WriteJsonString(out, event.function);
+      out << "}}";
+    }
+    out << "\n]}\n";
+  }
+
+  // "SPYT", version, event count, then per event: spy, thread, line,
+  // start, duration and length-prefixed file, function and member strings
+  static void WriteBinary(std::ostream& out, const std::vector<SpyEvent>& events) {
+    out.write("SPYT", 4);
+    detail::WriteRaw(out, std::uint32_t{1});
+    detail::WriteRaw(out, static_cast<std::uint64_t>(events.size()));
+    for (const auto& event : events) {
+      detail::WriteRaw(out, reinterpret_cast<std::uintptr_t>(event.spy));
+      detail::WriteRaw(out, event.thread);
+      detail::WriteRaw(out, event.line);
+      detail::WriteRaw(out, event.start_ns);
+      detail::WriteRaw(out, event.duration_ns);
+      detail::WriteRawString(out, event.file);
+      detail::WriteRawString(out, event.function);
+      detail::WriteRawString(out, event.member ? event.member : "");
+    }
+  }
+};
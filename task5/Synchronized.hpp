@@ -0,0 +1,188 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "ThreadShards.hpp"
+
+
+namespace detail {
+  // Read-side bookkeeping of Synchronized: readers count themselves in
+  // their thread's cache-line padded shard, under the parity of the current
+  // epoch, so a read touches no line that other readers write. A writer
+  // waits for a grace period by flipping the parity and draining the
+  // counters of the old one, twice, which covers readers that saw either
+  // parity before it started. The reader's increment and pointer load and
+  // the writer's pointer exchange and counter loads are all seq_cst, so
+  // either the writer sees the reader or the reader sees the new pointer;
+  // unlike standalone fences, ThreadSanitizer understands this.
+  class EpochDomain {
+   public:
+    // Where a reader counted itself, so that leaving does not look up the
+    // thread's shard again
+    struct Ticket {
+      std::size_t shard;
+      unsigned int parity;
+    };
+
+    // Returns the ticket to hand back to Leave()
+    Ticket Enter() noexcept {
+      Ticket ticket{ThisThreadShard(), epoch_.load(std::memory_order_relaxed) & 1};
+      // A locked instruction on x86 whatever the order, so seq_cst costs
+      // nothing over relaxed
+      shards_[ticket.shard].readers[ticket.parity].fetch_add(1, std::memory_order_seq_cst);
+      return ticket;
+    }
+
+    void Leave(Ticket ticket) noexcept {
+      shards_[ticket.shard].readers[ticket.parity].fetch_sub(1, std::memory_order_release);
+    }
+
+    // Returns once every reader that might have seen the previous snapshot
+    // pointer has left. Writers are serialized by the caller
+    void Synchronize() noexcept {
+      for (int phase = 0; phase < 2; ++phase) {
+        unsigned int parity = epoch_.fetch_add(1, std::memory_order_relaxed) & 1;
+        for (auto& shard : shards_) {
+          while (shard.readers[parity].load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+          }
+        }
+      }
+    }
+
+   private:
+    struct alignas(kCacheLine) Shard {
+      std::array<std::atomic<unsigned int>, 2> readers{};
+    };
+
+    std::array<Shard, kSpyShards> shards_;
+    alignas(kCacheLine) std::atomic<unsigned int> epoch_{0};
+  };
+}
+
+// A T that is read far more often than written, such as a configuration or
+// a routing table. Like Spy, access goes through a wrapper that lives until
+// the end of the full expression:
+//   sync->field                        reads a snapshot, without locking
+//   sync.Write()->field = value;       copies, modifies and publishes
+//   auto snapshot = sync.Read();       keeps one snapshot across statements
+// Writers lock a mutex, edit a private copy and publish it when the wrapper
+// ends; the old copy is deleted once no reader can still see it. Readers
+// never block, but a writer waits for them, so a thread must not write while
+// it holds a read wrapper of the same Synchronized.
+template <class T>
+class Synchronized {
+  class ReadWrapper {
+   public:
+    explicit ReadWrapper(const Synchronized& sync)
+      : sync_(sync), ticket_(sync.domain_.Enter()), value_(sync.current_.load(std::memory_order_seq_cst)) {}
+
+    ReadWrapper(const ReadWrapper&) = delete;
+    ReadWrapper& operator=(const ReadWrapper&) = delete;
+
+    const T* operator->() const {
+      return value_;
+    }
+
+    const T& operator*() const {
+      return *value_;
+    }
+
+    ~ReadWrapper() {
+      sync_.domain_.Leave(ticket_);
+    }
+
+   private:
+    const Synchronized& sync_;
+    detail::EpochDomain::Ticket ticket_;
+    const T* value_;
+  };
+
+  class WriteWrapper {
+   public:
+    explicit WriteWrapper(Synchronized& sync)
+      : sync_(sync), lock_(sync.write_mutex_),
+        next_(std::make_unique<T>(*sync.current_.load(std::memory_order_relaxed))) {}
+
+    WriteWrapper(const WriteWrapper&) = delete;
+    WriteWrapper& operator=(const WriteWrapper&) = delete;
+
+    T* operator->() {
+      return next_.get();
+    }
+
+    T& operator*() {
+      return *next_;
+    }
+
+    ~WriteWrapper() {
+      sync_.Publish(std::move(next_));
+    }
+
+   private:
+    Synchronized& sync_;
+    std::unique_lock<std::mutex> lock_;
+    std::unique_ptr<T> next_;
+  };
+
+ public:
+  Synchronized() requires (std::default_initializable<T>)
+    : current_(new T()) {}
+
+  explicit Synchronized(T value) : current_(new T(std::move(value))) {}
+
+  Synchronized(const Synchronized&) = delete;
+  Synchronized& operator=(const Synchronized&) = delete;
+
+  // No wrapper may outlive the Synchronized
+  ~Synchronized() {
+    delete current_.load(std::memory_order_relaxed);
+  }
+
+  ReadWrapper operator->() const {
+    return ReadWrapper(*this);
+  }
+
+  ReadWrapper Read() const {
+    return ReadWrapper(*this);
+  }
+
+  // Copy-on-write access, published when the wrapper ends
+  WriteWrapper Write() requires (std::copy_constructible<T>) {
+    return WriteWrapper(*this);
+  }
+
+  T Load() const requires (std::copy_constructible<T>) {
+    return *Read();
+  }
+
+  // Replaces the value without copying the old one
+  void Store(T value) {
+    std::lock_guard lock(write_mutex_);
+    Publish(std::make_unique<T>(std::move(value)));
+  }
+
+  template <std::invocable<T&> F>
+  void Update(F&& update) requires (std::copy_constructible<T>) {
+    auto writer = Write();
+    std::forward<F>(update)(*writer);
+  }
+
+ private:
+  // Called with write_mutex_ held
+  void Publish(std::unique_ptr<T> next) {
+    std::unique_ptr<T> previous(current_.exchange(next.release(), std::memory_order_seq_cst));
+    domain_.Synchronize();
+  }
+
+  mutable detail::EpochDomain domain_;
+  std::atomic<T*> current_;
+  std::mutex write_mutex_;
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+
+// Per-thread sharding shared by Spy's counters and Synchronized's readers:
+// each thread keeps to one of kSpyShards cache-line padded slots, so
+// threads on different shards never write the same line.
+namespace detail {
+  inline constexpr std::size_t kCacheLine = 64;
+  inline constexpr std::size_t kSpyShards = 64;
+
+  inline std::size_t ThisThreadShard() {
+    static std::atomic<std::size_t> next_shard{0};
+    thread_local const std::size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kSpyShards;
+    return shard;
+  }
+}
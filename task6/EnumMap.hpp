@@ -0,0 +1,310 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+#include "EnumeratorTraits.hpp"
+
+
+// Flat containers keyed by the enumerators of Enum. A key maps to its dense
+// index through EnumeratorTraits::indexOf, so there is no hashing at runtime
+// and iteration follows EnumeratorTraits order (ascending by value).
+
+template <class Enum, class V, std::size_t MAXN = 512> requires std::is_enum_v<Enum>
+class EnumMap {
+  using Traits = EnumeratorTraits<Enum, MAXN>;
+
+  template <class Value>
+  struct Entry {
+    Enum key;
+    Value& value;
+  };
+
+  template <class Value>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = Entry<Value>;
+
+    constexpr Iterator() = default;
+    constexpr Iterator(Value* values, std::size_t index) : values_(values), index_(index) {}
+
+    constexpr Entry<Value> operator*() const {
+      return {Traits::at(index_), values_[index_]};
+    }
+
+    constexpr Iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+
+    constexpr Iterator operator++(int) {
+      Iterator copy = *this;
+      ++index_;
+      return copy;
+    }
+
+    constexpr bool operator==(const Iterator& other) const {
+      return index_ == other.index_;
+    }
+
+   private:
+    Value* values_ = nullptr;
+    std::size_t index_ = 0;
+  };
+
+ public:
+  using key_type = Enum;
+  using mapped_type = V;
+  using iterator = Iterator<V>;
+  using const_iterator = Iterator<const V>;
+
+  constexpr EnumMap() = default;
+
+  explicit constexpr EnumMap(const V& value) {
+    values_.fill(value);
+  }
+
+  static constexpr std::size_t Size() noexcept {
+    return Traits::size();
+  }
+
+  static constexpr bool Contains(Enum key) noexcept {
+    return Traits::indexOf(key) < Size();
+  }
+
+  // key must be an enumerator
+  constexpr V& operator[](Enum key) {
+    std::size_t i = Traits::indexOf(key);
+    assert(i < Size());
+    return values_[i];
+  }
+
+  constexpr const V& operator[](Enum key) const {
+    std::size_t i = Traits::indexOf(key);
+    assert(i < Size());
+    return values_[i];
+  }
+
+  // nullptr if key is not an enumerator
+  constexpr V* Find(Enum key) noexcept {
+    std::size_t i = Traits::indexOf(key);
+    return i < Size() ? &values_[i] : nullptr;
+  }
+
+  constexpr const V* Find(Enum key) const noexcept {
+    std::size_t i = Traits::indexOf(key);
+    return i < Size() ? &values_[i] : nullptr;
+  }
+
+  constexpr void Fill(const V& value) {
+    values_.fill(value);
+  }
+
+  // Values in key order
+  constexpr std::array<V, Traits::size()>& Values() noexcept {
+    return values_;
+  }
+
+  constexpr const std::array<V, Traits::size()>& Values() const noexcept {
+    return values_;
+  }
+
+  constexpr iterator begin() noexcept {
+    return iterator(values_.data(), 0);
+  }
+
+  constexpr iterator end() noexcept {
+    return iterator(values_.data(), Size());
+  }
+
+  constexpr const_iterator begin() const noexcept {
+    return const_iterator(values_.data(), 0);
+  }
+
+  constexpr const_iterator end() const noexcept {
+    return const_iterator(values_.data(), Size());
+  }
+
+  constexpr bool operator==(const EnumMap&) const = default;
+
+ private:
+  std::array<V, Traits::size()> values_{};
+};
+
+
+template <class Enum, std::size_t MAXN = 512> requires std::is_enum_v<Enum>
+class EnumSet {
+  using Traits = EnumeratorTraits<Enum, MAXN>;
+  static constexpr std::size_t kWords = (Traits::size() + 63) / 64;
+
+ public:
+  // Walks the set bits word by word with countr_zero
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = Enum;
+
+    constexpr Iterator() = default;
+    constexpr Iterator(const std::uint64_t* words, std::size_t word)
+      : words_(words), word_(word), bits_(word < kWords ? words[word] : 0) {
+      Settle();
+    }
+
+    constexpr Enum operator*() const {
+      return Traits::at(word_ * 64 + std::countr_zero(bits_));
+    }
+
+    constexpr Iterator& operator++() {
+      bits_ &= bits_ - 1;
+      Settle();
+      return *this;
+    }
+
+    constexpr Iterator operator++(int) {
+      Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    constexpr bool operator==(const Iterator& other) const {
+      return word_ == other.word_ && bits_ == other.bits_;
+    }
+
+   private:
+    // Moves to the next word with set bits, or to the end
+    constexpr void Settle() {
+      while (bits_ == 0 && ++word_ < kWords) {
+        bits_ = words_[word_];
+      }
+      if (bits_ == 0) {
+        word_ = kWords;
+      }
+    }
+
+    const std::uint64_t* words_ = nullptr;
+    std::size_t word_ = kWords;
+    std::uint64_t bits_ = 0;
+  };
+
+  using key_type = Enum;
+  using value_type = Enum;
+  using iterator = Iterator;
+  using const_iterator = Iterator;
+
+  constexpr EnumSet() = default;
+
+  constexpr EnumSet(std::initializer_list<Enum> keys) {
+    for (Enum key : keys) {
+      Insert(key);
+    }
+  }
+
+  static constexpr EnumSet All() noexcept {
+    EnumSet set;
+    for (std::size_t w = 0; w < kWords; ++w) {
+      set.words_[w] = ~std::uint64_t{0};
+    }
+    if constexpr (Traits::size() % 64 != 0) {
+      set.words_[kWords - 1] = (std::uint64_t{1} << (Traits::size() % 64)) - 1;
+    }
+    return set;
+  }
+
+  static constexpr std::size_t Capacity() noexcept {
+    return Traits::size();
+  }
+
+  constexpr std::size_t Size() const noexcept {
+    std::size_t size = 0;
+    for (auto word : words_) {
+      size += std::popcount(word);
+    }
+    return size;
+  }
+
+  [[nodiscard]] constexpr bool Empty() const noexcept {
+    for (auto word : words_) {
+      if (word != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  constexpr bool Contains(Enum key) const noexcept {
+    std::size_t i = Traits::indexOf(key);
+    return i < Capacity() && (words_[i / 64] >> (i % 64) & 1) != 0;
+  }
+
+  // key must be an enumerator
+  constexpr void Insert(Enum key) {
+    std::size_t i = Traits::indexOf(key);
+    assert(i < Capacity());
+    words_[i / 64] |= std::uint64_t{1} << (i % 64);
+  }
+
+  constexpr void Erase(Enum key) noexcept {
+    std::size_t i = Traits::indexOf(key);
+    if (i < Capacity()) {
+      words_[i / 64] &= ~(std::uint64_t{1} << (i % 64));
+    }
+  }
+
+  constexpr void Clear() noexcept {
+    words_.fill(0);
+  }
+
+  constexpr EnumSet& operator|=(const EnumSet& other) noexcept {
+    for (std::size_t w = 0; w < kWords; ++w) {
+      words_[w] |= other.words_[w];
+    }
+    return *this;
+  }
+
+  constexpr EnumSet& operator&=(const EnumSet& other) noexcept {
+    for (std::size_t w = 0; w < kWords; ++w) {
+      words_[w] &= other.words_[w];
+    }
+    return *this;
+  }
+
+  constexpr EnumSet& operator-=(const EnumSet& other) noexcept {
+    for (std::size_t w = 0; w < kWords; ++w) {
+      words_[w] &= ~other.words_[w];
+    }
+    return *this;
+  }
+
+  friend constexpr EnumSet operator|(EnumSet lhs, const EnumSet& rhs) noexcept {
+    return lhs |= rhs;
+  }
+
+  friend constexpr EnumSet operator&(EnumSet lhs, const EnumSet& rhs) noexcept {
+    return lhs &= rhs;
+  }
+
+  friend constexpr EnumSet operator-(EnumSet lhs, const EnumSet& rhs) noexcept {
+    return lhs -= rhs;
+  }
+
+  constexpr bool operator==(const EnumSet&) const = default;
+
+  constexpr iterator begin() const noexcept {
+    return Iterator(words_.data(), 0);
+  }
+
+  constexpr iterator end() const noexcept {
+    return Iterator(words_.data(), kWords);
+  }
+
+ private:
+  std::array<std::uint64_t, kWords> words_{};
+};
@@ -1,44 +1,267 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cstdint>
 #include <limits>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 
 
+// Inclusive range of values probed by EnumeratorTraits
+struct EnumRange {
+  long long lo;
+  long long hi;
+};
+
 namespace detail {
 
-  template<auto T>
+  // One instantiation names a whole chunk of candidates:
+  // "... [with auto ...Vs = {(Enum)-1, Enum::A, (Enum)1}]" on GCC,
+  // "... [Vs = <(Enum)-1, Enum::A, (Enum)1>]" on Clang
+  template<auto... Vs>
   constexpr auto Helper() {
     return __PRETTY_FUNCTION__;
   }
 
-  template <class Enum, auto I> requires std::is_enum_v<Enum>
-  constexpr Enum GetEnumValue() {
-    return static_cast<Enum>(I);
+  inline constexpr std::size_t kProbeChunk = 256;
+
+  template <class Enum>
+  struct EnumEntry {
+    Enum value{};
+    std::string_view name;
+  };
+
+  // Names back to back, NUL-separated: name i is [offsets[i], offsets[i + 1] - 1)
+  template <std::size_t N, std::size_t bytes>
+  struct EnumNames {
+    static_assert(bytes <= std::numeric_limits<std::uint16_t>::max(), "enumerator names do not fit 16-bit offsets");
+
+    std::array<char, bytes> blob{};
+    std::array<std::uint16_t, N + 1> offsets{};
+
+    constexpr std::string_view operator[](std::size_t i) const {
+      return std::string_view(blob.data() + offsets[i], offsets[i + 1] - offsets[i] - 1);
+    }
+  };
+
+  template <class Enum, std::size_t N>
+  struct EnumScan {
+    std::array<EnumEntry<Enum>, N> entries{};
+    std::size_t size = 0;
+  };
+
+  // Returns the position right after the element starting at pos
+  constexpr std::size_t SkipPackElement(std::string_view str_v, std::size_t pos) {
+    int depth = 0;
+    for (; pos < str_v.size(); ++pos) {
+      char c = str_v[pos];
+      if (depth == 0 && (c == ',' || c == '}' || c == '>')) {
+        return pos;
+      }
+      if (c == '(' || c == '<' || c == '[' || c == '{') {
+        ++depth;
+      } else if (c == ')' || c == '>' || c == ']' || c == '}') {
+        --depth;
+      }
+    }
+    return pos;
+  }
+
+  // Appends the enumerators among Vs to scan, in the order of Vs
+  template <class Enum, class T, T... Vs, std::size_t N>
+  constexpr void ProbeValues(std::integer_sequence<T, Vs...>, EnumScan<Enum, N>& scan) {
+    constexpr T candidates[] = {Vs...};
+    const std::string_view str_v = Helper<static_cast<Enum>(Vs)...>();
+    std::size_t pos = str_v.find("Vs = ") + 6;
+    for (T candidate : candidates) {
+      std::size_t end = SkipPackElement(str_v, pos);
+      if (str_v[pos] != '(') {
+        std::string_view name = str_v.substr(pos, end - pos);
+        name.remove_prefix(name.find_last_of(':') + 1);
+        scan.entries[scan.size++] = {static_cast<Enum>(candidate), name};
+      }
+      pos = end + 2;
+    }
+  }
+
+  template <class Enum, long long first, std::size_t... I, std::size_t N>
+  constexpr void ProbeChunk(std::index_sequence<I...>, EnumScan<Enum, N>& scan) {
+    ProbeValues(std::integer_sequence<long long, first + static_cast<long long>(I)...>(), scan);
+  }
+
+  template <class Enum, long long lo, long long hi, std::size_t N>
+  constexpr void ProbeRange(EnumScan<Enum, N>& scan) {
+    constexpr std::size_t count = static_cast<std::size_t>(hi - lo + 1);
+    [&scan]<std::size_t... C>(std::index_sequence<C...>) {
+      (ProbeChunk<Enum, lo + static_cast<long long>(C * kProbeChunk)>(
+        std::make_index_sequence<std::min(kProbeChunk, count - C * kProbeChunk)>(), scan), ...);
+    }(std::make_index_sequence<(count + kProbeChunk - 1) / kProbeChunk>());
+  }
+
+  // Probes every value of the ranges in chunks of kProbeChunk values, in order
+  template <class Enum, auto ranges>
+  consteval auto ScanEnum() {
+    constexpr std::size_t count = [] {
+      std::size_t total = 0;
+      for (const auto& range : ranges) {
+        total += static_cast<std::size_t>(range.hi - range.lo + 1);
+      }
+      return total;
+    }();
+    EnumScan<Enum, count> scan;
+    [&scan]<std::size_t... R>(std::index_sequence<R...>) {
+      (ProbeRange<Enum, ranges[R].lo, ranges[R].hi>(scan), ...);
+    }(std::make_index_sequence<ranges.size()>());
+    return scan;
+  }
+
+  // Probes 0 and every single bit of the underlying type in one instantiation
+  template <class Enum>
+  consteval auto ScanFlags() {
+    using U = std::underlying_type_t<Enum>;
+    using Bits = std::make_unsigned_t<U>;
+    constexpr std::size_t bits = std::numeric_limits<Bits>::digits;
+    EnumScan<Enum, bits + 1> scan;
+    [&scan]<std::size_t... K>(std::index_sequence<K...>) {
+      ProbeValues(std::integer_sequence<U, U{0}, static_cast<U>(Bits{1} << K)...>(), scan);
+    }(std::make_index_sequence<bits>());
+    return scan;
+  }
+
+  constexpr std::uint64_t Mix(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
   }
 
-  template <class Enum, long I> requires std::is_enum_v<Enum>
-  constexpr bool IsInEnum() {
-    const std::string_view str_v = Helper<GetEnumValue<Enum, I>()>();
-    return str_v[str_v.rfind('=') + 2] != '(';
+  constexpr std::uint64_t PerfectHashOf(std::uint64_t key, std::uint64_t seed) {
+    std::uint64_t hash = (key ^ (seed * 0x9e3779b97f4a7c15ull)) * 0xbf58476d1ce4e5b9ull;
+    return hash ^ (hash >> 31);
   }
 
-  template <class Enum, long I> requires std::is_enum_v<Enum>
-  consteval std::string_view GetEnumName() {
-    std::string_view str_v = Helper<GetEnumValue<Enum, I>()>();
-    std::size_t pos = str_v.rfind('=') + 2;
-    str_v = str_v.substr(pos, str_v.size() - pos - 1);
-    pos = str_v.find_last_of(':') + 1;
-    if (pos != std::string_view::npos) {
-        str_v = str_v.substr(pos, str_v.size() - pos);
+  constexpr std::uint64_t PerfectHashOf(std::string_view key, std::uint64_t seed) {
+    std::uint64_t hash = 0xcbf29ce484222325ull ^ seed;
+    for (char c : key) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 0x100000001b3ull;
     }
-    return str_v;
+    return Mix(hash);
+  }
+
+  // Minimal perfect hash of N distinct keys ("hash and displace"): keys are
+  // split into buckets by their seed 0 hash, then every bucket, largest
+  // first, gets the first seed sending all its keys to free slots
+  template <std::size_t N>
+  struct PerfectHash {
+    static constexpr std::size_t kBuckets = N / 4 + 1;
+
+    std::array<std::uint32_t, kBuckets> seed{};
+    // Slot -> index of the key
+    std::array<std::uint32_t, N> index{};
+
+    template <class Key>
+    constexpr std::size_t Find(const Key& key) const {
+      std::uint32_t d = seed[PerfectHashOf(key, 0) % kBuckets];
+      return index[PerfectHashOf(key, d) % N];
+    }
+  };
+
+  template <class Key, std::size_t N>
+  consteval PerfectHash<N> BuildPerfectHash(const std::array<Key, N>& keys) {
+    using Hash = PerfectHash<N>;
+    Hash result;
+    if constexpr (N > 0) {
+      std::array<std::size_t, Hash::kBuckets + 1> start{};
+      for (const auto& key : keys) {
+        ++start[PerfectHashOf(key, 0) % Hash::kBuckets + 1];
+      }
+      for (std::size_t b = 0; b < Hash::kBuckets; ++b) {
+        start[b + 1] += start[b];
+      }
+      std::array<std::size_t, N> members{};
+      std::array<std::size_t, Hash::kBuckets> filled{};
+      for (std::size_t i = 0; i < N; ++i) {
+        auto b = PerfectHashOf(keys[i], 0) % Hash::kBuckets;
+        members[start[b] + filled[b]++] = i;
+      }
+
+      std::array<std::size_t, Hash::kBuckets> order{};
+      for (std::size_t b = 0; b < Hash::kBuckets; ++b) {
+        order[b] = b;
+      }
+      std::sort(order.begin(), order.end(), [&filled](std::size_t lhs, std::size_t rhs) {
+        return filled[lhs] > filled[rhs];
+      });
+
+      std::array<bool, N> used{};
+      std::array<std::size_t, N> slots{};
+      for (std::size_t o = 0; o < Hash::kBuckets && filled[order[o]] > 0; ++o) {
+        auto b = order[o];
+        for (std::uint32_t d = 1;; ++d) {
+          bool fits = true;
+          for (std::size_t k = 0; k < filled[b] && fits; ++k) {
+            slots[k] = PerfectHashOf(keys[members[start[b] + k]], d) % N;
+            fits = !used[slots[k]];
+            for (std::size_t j = 0; j < k && fits; ++j) {
+              fits = slots[j] != slots[k];
+            }
+          }
+          if (fits) {
+            for (std::size_t k = 0; k < filled[b]; ++k) {
+              used[slots[k]] = true;
+              result.index[slots[k]] = static_cast<std::uint32_t>(members[start[b] + k]);
+            }
+            result.seed[b] = d;
+            break;
+          }
+        }
+      }
+    }
+    return result;
+  }
+
+  // "0" or a lowercase "0x..." number of at most sizeof(Bits) bytes
+  template <class Bits>
+  constexpr std::optional<Bits> ParseFlagNumber(std::string_view part) {
+    if (part == "0") {
+      return Bits{0};
+    }
+    if (part.size() <= 2 || part.size() > 2 + 2 * sizeof(Bits) || !part.starts_with("0x")) {
+      return std::nullopt;
+    }
+    Bits number = 0;
+    for (char c : part.substr(2)) {
+      int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+      if (digit < 0) {
+        return std::nullopt;
+      }
+      number = static_cast<Bits>(number << 4 | static_cast<Bits>(digit));
+    }
+    return number;
   }
 
 } // namespace
 
+// Specialize as true for bitmask enums: EnumeratorTraits then finds 0 and the
+// single-bit enumerators whatever their magnitude, and enables formatFlags/parseFlags
+template <class Enum>
+inline constexpr bool is_flag_enum = false;
+
+// Specialize with ascending disjoint ranges for enums with values beyond MAXN:
+//   template <> inline constexpr std::array enum_ranges<Code> = {EnumRange{0, 99}, EnumRange{30000, 30099}};
+// EnumeratorTraits then probes those ranges instead of [-MAXN, MAXN]
+template <class Enum>
+inline constexpr std::array<EnumRange, 0> enum_ranges{};
+
 template <class Enum, std::size_t MAXN = 512> requires std::is_enum_v<Enum>
 struct EnumeratorTraits {
  private:
@@ -47,49 +270,61 @@ struct EnumeratorTraits {
   static constexpr int MAX_IT = std::min(MAX_LIMIT, static_cast<unsigned long long>(MAXN));
   static constexpr int MIN_IT = std::max(MIN_LIMIT, -static_cast<long long>(MAXN));
 
-  static consteval std::size_t CalculateEnumSize() {
-    std::size_t size = 0;
-    if constexpr(std::is_signed<std::underlying_type_t<Enum>>::value && MIN_IT < 0) {
-      [&size]<int... I>(std::integer_sequence<int, I...>) {
-        ([&size](){
-          if (detail::IsInEnum<Enum, I + MIN_IT>()) {
-            ++size;
-          }
-        }(), ...);
-      }(std::make_integer_sequence<int, -MIN_IT>());
+  static consteval bool ValidRanges() {
+    const auto& ranges = enum_ranges<Enum>;
+    for (std::size_t r = 0; r < ranges.size(); ++r) {
+      if (ranges[r].lo > ranges[r].hi || ranges[r].lo < MIN_LIMIT ||
+          (ranges[r].hi > 0 && static_cast<unsigned long long>(ranges[r].hi) > MAX_LIMIT) ||
+          (r > 0 && ranges[r - 1].hi >= ranges[r].lo)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static_assert(ValidRanges(), "enum_ranges must be ascending, disjoint and within the underlying type");
+
+  static consteval auto Scan() {
+    if constexpr (is_flag_enum<Enum>) {
+      return detail::ScanFlags<Enum>();
+    } else if constexpr (enum_ranges<Enum>.size() > 0) {
+      return detail::ScanEnum<Enum, enum_ranges<Enum>>();
+    } else {
+      return detail::ScanEnum<Enum, std::array{EnumRange{MIN_IT, MAX_IT}}>();
+    }
+  }
+
+  // Every candidate is probed exactly once, here
+  static constexpr auto scan_ = Scan();
+
+  static consteval auto CalculateValues() {
+    std::array<Enum, scan_.size> result;
+    for (std::size_t i = 0; i < scan_.size; ++i) {
+      result[i] = scan_.entries[i].value;
     }
-    [&size]<int... I>(std::integer_sequence<int, I...>) {
-      ([&size](){
-        if (detail::IsInEnum<Enum, I>()) {
-          ++size;
-        }
-      }(), ...);
-    }(std::make_integer_sequence<int, MAX_IT + 1>());
-    return size;
-  }
-
-  template <auto Func>
-  static consteval auto CalculateEnum() {
-    std::array<decltype(Func.template operator()<Enum, 0>()), CalculateEnumSize()> result;
-    std::size_t i = 0;
-    if constexpr(std::is_signed<std::underlying_type_t<Enum>>::value && MIN_IT < 0) {
-      [&result, &i]<int... I>(std::integer_sequence<int, I...>) {
-        ([&result, &i](){
-          if (detail::IsInEnum<Enum, I + MIN_IT>()) {
-            result[i] = Func.template operator()<Enum, I + MIN_IT>();
-            ++i;
-          }
-        }(), ...);
-      }(std::make_integer_sequence<int, -MIN_IT>());
-    }
-    [&]<int... I>(std::integer_sequence<int, I...>) {
-      ([&result, &i](){
-        if (detail::IsInEnum<Enum, I>()) {
-          result[i] = Func.template operator()<Enum, I>();
-          ++i;
-        }
-      }(), ...);
-    }(std::make_integer_sequence<int, MAX_IT + 1>());
+    return result;
+  }
+
+  static consteval std::size_t CalculateNameBytes() {
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < scan_.size; ++i) {
+      bytes += scan_.entries[i].name.size() + 1;
+    }
+    return bytes;
+  }
+
+  // Copies the names out of the probed signatures, so only they reach the binary
+  static consteval auto CalculateNames() {
+    detail::EnumNames<scan_.size, CalculateNameBytes()> result;
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < scan_.size; ++i) {
+      result.offsets[i] = static_cast<std::uint16_t>(pos);
+      for (char c : scan_.entries[i].name) {
+        result.blob[pos++] = c;
+      }
+      result.blob[pos++] = '\0';
+    }
+    result.offsets[scan_.size] = static_cast<std::uint16_t>(pos);
     return result;
   }
 
@@ -106,9 +341,162 @@ struct EnumeratorTraits {
     return enum_names_[i];
   }
 
+  // Index of the enumerator with this value, size() if there is none
+  static constexpr std::size_t indexOf(Enum value) noexcept {
+    if constexpr (size() == 0) {
+      return 0;
+    } else if constexpr (contiguous_) {
+      auto offset = static_cast<std::uint64_t>(Underlying(value)) - static_cast<std::uint64_t>(Underlying(at(0)));
+      return offset < size() ? static_cast<std::size_t>(offset) : size();
+    } else {
+      std::size_t i = Lookup::value_hash.Find(static_cast<std::uint64_t>(Underlying(value)));
+      return at(i) == value ? i : size();
+    }
+  }
+
+  // Empty for values that are not enumerators
+  static constexpr std::string_view nameOf(Enum value) noexcept {
+    std::size_t i = indexOf(value);
+    return i < size() ? nameAt(i) : std::string_view();
+  }
+
+  static constexpr std::optional<Enum> fromName(std::string_view name) noexcept {
+    if constexpr (size() == 0) {
+      return std::nullopt;
+    } else {
+      std::size_t i = Lookup::name_hash.Find(name);
+      return nameAt(i) == name ? std::optional<Enum>(at(i)) : std::nullopt;
+    }
+  }
+
+  // Writes "A|B|C" for the set bits of value into buffer, bits without an
+  // enumerator as one trailing hex number. Returns the written part of buffer,
+  // nothing if it does not fit
+  static constexpr std::optional<std::string_view> formatFlags(Enum value, std::span<char> buffer) noexcept
+    requires is_flag_enum<Enum>
+  {
+    using Bits = std::make_unsigned_t<std::underlying_type_t<Enum>>;
+    auto bits = static_cast<Bits>(value);
+    std::size_t pos = 0;
+    auto append = [&buffer, &pos](std::string_view part) {
+      if (buffer.size() - pos < part.size() + (pos != 0)) {
+        return false;
+      }
+      if (pos != 0) {
+        buffer[pos++] = '|';
+      }
+      std::copy(part.begin(), part.end(), buffer.begin() + pos);
+      pos += part.size();
+      return true;
+    };
+    if (bits == 0) {
+      auto name = nameOf(value);
+      if (!append(name.empty() ? std::string_view("0") : name)) {
+        return std::nullopt;
+      }
+      return std::string_view(buffer.data(), pos);
+    }
+    Bits unnamed = 0;
+    for (Bits rest = bits; rest != 0; rest &= rest - 1) {
+      Bits bit = rest & (~rest + 1);
+      auto name = nameOf(static_cast<Enum>(bit));
+      if (name.empty()) {
+        unnamed |= bit;
+      } else if (!append(name)) {
+        return std::nullopt;
+      }
+    }
+    if (unnamed != 0) {
+      char hex[2 + 2 * sizeof(Bits)] = {'0', 'x'};
+      std::size_t digits = (std::bit_width(unnamed) + 3) / 4;
+      for (std::size_t d = 0; d < digits; ++d) {
+        hex[1 + digits - d] = "0123456789abcdef"[(unnamed >> (4 * d)) & 0xf];
+      }
+      if (!append(std::string_view(hex, 2 + digits))) {
+        return std::nullopt;
+      }
+    }
+    return std::string_view(buffer.data(), pos);
+  }
+
+  // Inverse of formatFlags: '|'-separated names or hex numbers, spaces around
+  // them ignored. Nothing if some part is neither
+  static constexpr std::optional<Enum> parseFlags(std::string_view text) noexcept
+    requires is_flag_enum<Enum>
+  {
+    using Bits = std::make_unsigned_t<std::underlying_type_t<Enum>>;
+    Bits bits = 0;
+    while (true) {
+      std::size_t end = std::min(text.find('|'), text.size());
+      std::string_view part = text.substr(0, end);
+      part.remove_prefix(std::min(part.find_first_not_of(' '), part.size()));
+      part.remove_suffix(part.size() - (part.find_last_not_of(' ') + 1));
+      if (auto flag = fromName(part)) {
+        bits |= static_cast<Bits>(*flag);
+      } else if (auto number = detail::ParseFlagNumber<Bits>(part)) {
+        bits |= *number;
+      } else {
+        return std::nullopt;
+      }
+      if (end == text.size()) {
+        return static_cast<Enum>(bits);
+      }
+      text.remove_prefix(end + 1);
+    }
+  }
+
  private:
-  static constexpr auto GetNameF_ = []<class Enum_, long I_>() { return detail::GetEnumName<Enum_, I_>(); };
-  static constexpr auto GetValueF_ = []<class Enum_, auto I_>() { return detail::GetEnumValue<Enum_, I_>(); };
-  static constexpr auto enum_names_ = CalculateEnum<GetNameF_>();
-  static constexpr auto enum_values_ = CalculateEnum<GetValueF_>();
+  static constexpr long long Underlying(Enum value) noexcept {
+    return static_cast<long long>(static_cast<std::underlying_type_t<Enum>>(value));
+  }
+
+  static constexpr auto enum_values_ = CalculateValues();
+  static constexpr auto enum_names_ = CalculateNames();
+
+  static constexpr bool contiguous_ =
+    size() == 0 ||
+    static_cast<std::uint64_t>(Underlying(at(size() - 1))) - static_cast<std::uint64_t>(Underlying(at(0))) == size() - 1;
+
+  // Built only once nameOf or fromName is used
+  struct Lookup {
+    static consteval auto CalculateValueHash() {
+      std::array<std::uint64_t, contiguous_ ? 0 : size()> values{};
+      for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<std::uint64_t>(Underlying(at(i)));
+      }
+      return detail::BuildPerfectHash(values);
+    }
+
+    static consteval auto CalculateNameHash() {
+      std::array<std::string_view, size()> names{};
+      for (std::size_t i = 0; i < size(); ++i) {
+        names[i] = nameAt(i);
+      }
+      return detail::BuildPerfectHash(names);
+    }
+
+    static constexpr auto value_hash = CalculateValueHash();
+    static constexpr auto name_hash = CalculateNameHash();
+  };
 };
+
+
+template <class Enum> requires std::is_enum_v<Enum>
+constexpr std::string_view NameOf(Enum value) noexcept {
+  return EnumeratorTraits<Enum>::nameOf(value);
+}
+
+template <class Enum> requires std::is_enum_v<Enum>
+constexpr std::optional<Enum> FromName(std::string_view name) noexcept {
+  return EnumeratorTraits<Enum>::fromName(name);
+}
+
+template <class Enum> requires is_flag_enum<Enum>
+constexpr std::optional<std::string_view> FormatFlags(Enum value, std::span<char> buffer) noexcept {
+  return EnumeratorTraits<Enum>::formatFlags(value, buffer);
+}
+
+template <class Enum> requires is_flag_enum<Enum>
+constexpr std::optional<Enum> ParseFlags(std::string_view text) noexcept {
+  return EnumeratorTraits<Enum>::parseFlags(text);
+}
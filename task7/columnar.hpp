@@ -0,0 +1,435 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "reflect.hpp"
+#include "../task1/Span.hpp"
+
+
+// Field annotation for ColumnarBatch:
+//   Annotate<Nullable>  a std::optional<U> field, stored as a column of U
+//                       plus a validity bitmap (bit set = value present)
+struct Nullable {};
+
+
+namespace detail {
+
+    template <class U>
+    inline constexpr bool kIsOptional = false;
+
+    template <class U>
+    inline constexpr bool kIsOptional<std::optional<U>> = true;
+
+    template <class Field, bool nullable = Field::template has_annotation_class<Nullable>>
+    struct SColumnOf {
+        using Type = std::remove_cv_t<typename Field::Type>;
+        static_assert(!kIsOptional<Type>, "optional fields need Annotate<Nullable>");
+    };
+
+    template <class Field>
+    struct SColumnOf<Field, true> {
+        static_assert(kIsOptional<std::remove_cv_t<typename Field::Type>>, "Nullable fields must be std::optional");
+        using Type = typename std::remove_cv_t<typename Field::Type>::value_type;
+    };
+
+    template <class U>
+    concept FixedEnum = std::is_enum_v<U> && requires(std::underlying_type_t<U> raw) { U{raw}; };
+
+    // Whether a column of U read from a block needs no check of its values:
+    // every byte pattern of U is a U, except for bool, which is checked on
+    // Parse. Enums without a fixed underlying type have a narrower range.
+    template <class U>
+    inline constexpr bool kReadableColumn = std::is_arithmetic_v<U> || FixedEnum<U>;
+
+    inline constexpr std::size_t kColumnAlignment = 64;
+
+    constexpr std::size_t AlignColumn(std::size_t bytes) {
+        return (bytes + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment;
+    }
+
+    // Growable array of trivially copyable E on a 64-byte boundary
+    template <class E>
+    class AlignedColumn {
+        static_assert(std::is_trivially_copyable_v<E>, "columns hold trivially copyable values");
+
+     public:
+        AlignedColumn() = default;
+
+        void Push(const E& value) {
+            if (size_ == capacity_) {
+                Reserve(std::max<std::size_t>(kColumnAlignment / sizeof(E) + 1, capacity_ * 2));
+            }
+            std::memcpy(data_.get() + size_, &value, sizeof(E));
+            ++size_;
+        }
+
+        void Reserve(std::size_t capacity) {
+            if (capacity <= capacity_) {
+                return;
+            }
+            std::unique_ptr<E[], Free> grown(static_cast<E*>(
+                ::operator new(AlignColumn(capacity * sizeof(E)), std::align_val_t{kColumnAlignment})));
+            if (size_ != 0) {
+                std::memcpy(grown.get(), data_.get(), size_ * sizeof(E));
+            }
+            data_ = std::move(grown);
+            capacity_ = capacity;
+        }
+
+        void Resize(std::size_t size) {
+            Reserve(size);
+            if (size > size_) {
+                std::memset(data_.get() + size_, 0, (size - size_) * sizeof(E));
+            }
+            size_ = size;
+        }
+
+        void Clear() noexcept {
+            size_ = 0;
+        }
+
+        E* Data() noexcept {
+            return data_.get();
+        }
+
+        const E* Data() const noexcept {
+            return data_.get();
+        }
+
+        std::size_t Size() const noexcept {
+            return size_;
+        }
+
+     private:
+        struct Free {
+            void operator()(E* data) const noexcept {
+                ::operator delete(data, std::align_val_t{kColumnAlignment});
+            }
+        };
+
+        std::unique_ptr<E[], Free> data_;
+        std::size_t size_ = 0;
+        std::size_t capacity_ = 0;
+    };
+
+    template <class Field>
+    struct ColumnStorage {
+        static constexpr bool nullable = Field::template has_annotation_class<Nullable>;
+        using Type = typename SColumnOf<Field>::Type;
+
+        AlignedColumn<Type> values;
+        AlignedColumn<std::uint64_t> validity;
+    };
+
+    template <class Fields>
+    struct SColumnTuple;
+
+    template <class T, std::size_t... I>
+    struct SColumnTuple<std::pair<T, std::index_sequence<I...>>> {
+        using Type = std::tuple<ColumnStorage<typename Describe<T>::template Field<I>>...>;
+    };
+
+    // Block layout, native byte order, every section on a 64-byte offset:
+    //   ColumnarHeader, ColumnarColumn[columns], then per column its values
+    //   and, for nullable columns, ceil(rows / 64) validity words.
+    // block_bytes is a multiple of 64, so blocks written back to back keep
+    // their sections aligned in a memory-mapped file.
+    struct ColumnarHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t block_bytes;
+        std::uint64_t rows;
+        std::uint32_t columns;
+        std::uint32_t reserved;
+    };
+
+    struct ColumnarColumn {
+        std::uint64_t values_offset;
+        std::uint64_t validity_offset;  // 0 for columns without nulls
+        std::uint32_t element_size;
+        std::uint32_t nullable;
+    };
+
+    inline constexpr char kColumnarMagic[4] = {'C', 'O', 'L', 'B'};
+    inline constexpr std::uint32_t kColumnarVersion = 1;
+
+    inline void WritePadding(std::ostream& out, std::size_t bytes) {
+        static constexpr char kZeros[kColumnAlignment] = {};
+        out.write(kZeros, static_cast<std::streamsize>(AlignColumn(bytes) - bytes));
+    }
+
+} // namespace detail
+
+
+// Rows of the aggregate T stored column by column: field I of every row
+// lives in its own 64-byte-aligned buffer, so a scan of one field touches
+// only that field's bytes.
+template <class T>
+class ColumnarBatch {
+    using D = Describe<T>;
+    using Columns = typename detail::SColumnTuple<std::pair<T, std::make_index_sequence<D::num_fields>>>::Type;
+
+    template <std::size_t I>
+    using Storage = std::tuple_element_t<I, Columns>;
+
+ public:
+    static constexpr std::size_t num_columns = D::num_fields;
+
+    // Type of the values in column I, std::optional unwrapped
+    template <std::size_t I>
+    using ColumnType = typename Storage<I>::Type;
+
+    template <std::size_t I>
+    static constexpr bool is_nullable = Storage<I>::nullable;
+
+    void Append(const T& row) {
+        AppendFields(row, std::make_index_sequence<num_columns>());
+        ++rows_;
+    }
+
+    void Reserve(std::size_t rows) {
+        std::apply([rows](auto&... columns) {
+            (columns.values.Reserve(rows), ...);
+            (columns.validity.Reserve(columns.nullable ? (rows + 63) / 64 : 0), ...);
+        }, columns_);
+    }
+
+    void Clear() noexcept {
+        std::apply([](auto&... columns) {
+            (columns.values.Clear(), ...);
+            (columns.validity.Clear(), ...);
+        }, columns_);
+        rows_ = 0;
+    }
+
+    std::size_t Size() const noexcept {
+        return rows_;
+    }
+
+    // Null rows hold a value-initialized U
+    template <std::size_t I>
+    Span<const ColumnType<I>> Column() const noexcept {
+        const auto& values = std::get<I>(columns_).values;
+        return {values.Data(), values.Size()};
+    }
+
+    // Bit r % 64 of word r / 64 is set when row r has a value
+    template <std::size_t I> requires is_nullable<I>
+    Span<const std::uint64_t> Validity() const noexcept {
+        const auto& validity = std::get<I>(columns_).validity;
+        return {validity.Data(), validity.Size()};
+    }
+
+    template <std::size_t I>
+    bool IsNull(std::size_t row) const noexcept {
+        assert(row < rows_);
+        if constexpr (is_nullable<I>) {
+            return (std::get<I>(columns_).validity.Data()[row / 64] >> (row % 64) & 1) == 0;
+        } else {
+            return false;
+        }
+    }
+
+    // Writes the batch as one block of the format read by ColumnarBlock.
+    // Blocks can be streamed into the same file one after another.
+    void WriteTo(std::ostream& out) const {
+        std::size_t offset = detail::AlignColumn(
+            sizeof(detail::ColumnarHeader) + num_columns * sizeof(detail::ColumnarColumn));
+        std::array<detail::ColumnarColumn, num_columns> descriptors;
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((descriptors[I] = LayOut(offset, std::get<I>(columns_))), ...);
+        }(std::make_index_sequence<num_columns>());
+
+        detail::ColumnarHeader header{};
+        std::memcpy(header.magic, detail::kColumnarMagic, sizeof(header.magic));
+        header.version = detail::kColumnarVersion;
+        header.block_bytes = offset;
+        header.rows = rows_;
+        header.columns = static_cast<std::uint32_t>(num_columns);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(descriptors.data()), sizeof(descriptors));
+        detail::WritePadding(out, sizeof(header) + sizeof(descriptors));
+
+        std::apply([&out](const auto&... columns) {
+            (WriteColumn(out, columns), ...);
+        }, columns_);
+    }
+
+ private:
+    template <std::size_t... I>
+    void AppendFields(const T& row, std::index_sequence<I...>) {
+        (AppendField<I>(D::template Get<I>(row)), ...);
+    }
+
+    template <std::size_t I, class U>
+    void AppendField(const U& value) {
+        auto& column = std::get<I>(columns_);
+        if constexpr (is_nullable<I>) {
+            if (rows_ % 64 == 0) {
+                column.validity.Push(0);
+            }
+            if (value.has_value()) {
+                column.values.Push(*value);
+                column.validity.Data()[rows_ / 64] |= std::uint64_t{1} << (rows_ % 64);
+            } else {
+                column.values.Push(ColumnType<I>{});
+            }
+        } else {
+            column.values.Push(value);
+        }
+    }
+
+    // Lays the column out at offset and moves offset past it
+    template <class Column>
+    detail::ColumnarColumn LayOut(std::size_t& offset, const Column& column) const {
+        detail::ColumnarColumn descriptor{};
+        descriptor.element_size = sizeof(typename Column::Type);
+        descriptor.nullable = Column::nullable;
+        descriptor.values_offset = offset;
+        offset += detail::AlignColumn(column.values.Size() * sizeof(typename Column::Type));
+        if constexpr (Column::nullable) {
+            descriptor.validity_offset = offset;
+            offset += detail::AlignColumn(column.validity.Size() * sizeof(std::uint64_t));
+        }
+        return descriptor;
+    }
+
+    template <class Column>
+    static void WriteColumn(std::ostream& out, const Column& column) {
+        std::size_t bytes = column.values.Size() * sizeof(typename Column::Type);
+        out.write(reinterpret_cast<const char*>(column.values.Data()), static_cast<std::streamsize>(bytes));
+        detail::WritePadding(out, bytes);
+        if constexpr (Column::nullable) {
+            bytes = column.validity.Size() * sizeof(std::uint64_t);
+            out.write(reinterpret_cast<const char*>(column.validity.Data()), static_cast<std::streamsize>(bytes));
+            detail::WritePadding(out, bytes);
+        }
+    }
+
+    Columns columns_;
+    std::size_t rows_ = 0;
+};
+
+
+// Read-only view of one block written by ColumnarBatch<T>::WriteTo, typically
+// inside a memory-mapped file. Columns point into the block without copying.
+template <class T>
+class ColumnarBlock {
+    using Batch = ColumnarBatch<T>;
+
+ public:
+    static constexpr std::size_t num_columns = Batch::num_columns;
+
+    template <std::size_t I>
+    using ColumnType = typename Batch::template ColumnType<I>;
+
+    template <std::size_t I>
+    static constexpr bool is_nullable = Batch::template is_nullable<I>;
+
+    // Nothing if bytes does not start with a well-formed block of T, or if
+    // the block is not aligned for its columns. Reads the values of bool
+    // columns only, to check that they are 0 or 1.
+    static std::optional<ColumnarBlock> Parse(Span<const std::byte> bytes) {
+        detail::ColumnarHeader header;
+        if (bytes.Size() < sizeof(header)) {
+            return std::nullopt;
+        }
+        std::memcpy(&header, bytes.Data(), sizeof(header));
+        if (std::memcmp(header.magic, detail::kColumnarMagic, sizeof(header.magic)) != 0 ||
+            header.version != detail::kColumnarVersion || header.columns != num_columns ||
+            header.block_bytes > bytes.Size() || header.block_bytes % detail::kColumnAlignment != 0 ||
+            sizeof(header) + sizeof(detail::ColumnarColumn) * num_columns > header.block_bytes) {
+            return std::nullopt;
+        }
+
+        ColumnarBlock block;
+        block.base_ = bytes.Data();
+        block.bytes_ = static_cast<std::size_t>(header.block_bytes);
+        block.rows_ = static_cast<std::size_t>(header.rows);
+        std::memcpy(block.columns_.data(), bytes.Data() + sizeof(header), sizeof(block.columns_));
+        bool valid = [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return (block.template CheckColumn<I>() && ...);
+        }(std::make_index_sequence<num_columns>());
+        if (!valid) {
+            return std::nullopt;
+        }
+        return block;
+    }
+
+    std::size_t Size() const noexcept {
+        return rows_;
+    }
+
+    // Bytes taken by the block; the next block of a stream starts there
+    std::size_t BlockBytes() const noexcept {
+        return bytes_;
+    }
+
+    template <std::size_t I>
+    Span<const ColumnType<I>> Column() const noexcept {
+        return {reinterpret_cast<const ColumnType<I>*>(base_ + columns_[I].values_offset), rows_};
+    }
+
+    template <std::size_t I> requires is_nullable<I>
+    Span<const std::uint64_t> Validity() const noexcept {
+        return {reinterpret_cast<const std::uint64_t*>(base_ + columns_[I].validity_offset), (rows_ + 63) / 64};
+    }
+
+    template <std::size_t I>
+    bool IsNull(std::size_t row) const noexcept {
+        assert(row < rows_);
+        if constexpr (is_nullable<I>) {
+            return (Validity<I>()[row / 64] >> (row % 64) & 1) == 0;
+        } else {
+            return false;
+        }
+    }
+
+ private:
+    ColumnarBlock() = default;
+
+    bool CheckSection(std::uint64_t offset, std::size_t element_size, std::size_t count, std::size_t alignment) const {
+        return offset % detail::kColumnAlignment == 0 && offset <= bytes_ &&
+               count <= (bytes_ - offset) / element_size &&
+               reinterpret_cast<std::uintptr_t>(base_ + offset) % alignment == 0;
+    }
+
+    template <std::size_t I>
+    bool CheckColumn() const {
+        const auto& column = columns_[I];
+        using E = ColumnType<I>;
+        static_assert(detail::kReadableColumn<E>,
+                      "ColumnarBlock reads arithmetic columns and enums with a fixed underlying type");
+        if (column.element_size != sizeof(E) || column.nullable != is_nullable<I> ||
+            !CheckSection(column.values_offset, sizeof(E), rows_, alignof(E))) {
+            return false;
+        }
+        if constexpr (std::is_same_v<E, bool>) {
+            const auto* values = reinterpret_cast<const unsigned char*>(base_ + column.values_offset);
+            if (std::any_of(values, values + rows_, [](unsigned char value) { return value > 1; })) {
+                return false;
+            }
+        }
+        if constexpr (is_nullable<I>) {
+            return CheckSection(column.validity_offset, sizeof(std::uint64_t), (rows_ + 63) / 64, alignof(std::uint64_t));
+        }
+        return true;
+    }
+
+    const std::byte* base_ = nullptr;
+    std::size_t bytes_ = 0;
+    std::size_t rows_ = 0;
+    std::array<detail::ColumnarColumn, num_columns> columns_{};
+};
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "reflect.hpp"
+
+
+// Field annotation for ReflectHash/ReflectEqual:
+//   Annotate<NoHash>  the field takes part in neither the hash nor equality
+struct NoHash {};
+
+
+namespace detail {
+
+    template <class U>
+    inline constexpr bool kIsHashArray = false;
+
+    template <class E, std::size_t N>
+    inline constexpr bool kIsHashArray<std::array<E, N>> = true;
+
+    template <class U>
+    concept HashReflected = std::is_aggregate_v<U> && !std::is_array_v<U> && !kIsHashArray<U>;
+
+    template <class U>
+    constexpr bool IsBytewise();
+
+    template <class T, std::size_t... I>
+    constexpr bool FieldsBytewise(std::index_sequence<I...>) {
+        return (IsBytewise<std::remove_cv_t<typename Describe<T>::template Field<I>::Type>>() && ...);
+    }
+
+    // Equal values have equal bytes and the other way round: no padding, no
+    // floats, no Annotate members, and no nested type with its own operator==
+    template <class U>
+    constexpr bool IsBytewise() {
+        if constexpr (!std::has_unique_object_representations_v<U>) {
+            return false;
+        } else if constexpr (std::is_scalar_v<U>) {
+            return true;
+        } else if constexpr (kIsHashArray<U>) {
+            return IsBytewise<typename U::value_type>();
+        } else if constexpr (HashReflected<U> && !std::equality_comparable<U>) {
+            return FieldsBytewise<U>(std::make_index_sequence<Describe<U>::num_fields>());
+        } else {
+            return false;
+        }
+    }
+
+    template <class U>
+    inline constexpr bool kBytewise = IsBytewise<U>();
+
+    // The operator== of T itself is what ReflectEqual replaces, so unlike
+    // nested types it does not rule out the bytewise path
+    template <class T>
+    inline constexpr bool kBytewiseObject = std::has_unique_object_representations_v<T> &&
+        FieldsBytewise<T>(std::make_index_sequence<Describe<T>::num_fields>());
+
+    inline constexpr std::uint64_t kHashPrime1 = 0x9e3779b185ebca87;
+    inline constexpr std::uint64_t kHashPrime2 = 0xc2b2ae3d27d4eb4f;
+
+    inline constexpr std::uint64_t HashAvalanche(std::uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccd;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53;
+        h ^= h >> 33;
+        return h;
+    }
+
+    inline constexpr std::uint64_t HashCombine(std::uint64_t seed, std::uint64_t value) {
+        return std::rotl(seed ^ (value * kHashPrime2), 31) * kHashPrime1;
+    }
+
+    inline std::uint64_t LoadWord(const std::byte* bytes) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        return word;
+    }
+
+    // Hashes a buffer whose size is known at compile time. Four independent
+    // lanes of 8-byte words keep the multiplier busy; leftover words go to the
+    // first lanes and the zero-extended tail to the last one.
+    template <std::size_t size>
+    std::uint64_t HashBytes(const std::byte* bytes) {
+        constexpr std::size_t kBlocks = size / 32;
+        constexpr std::size_t kRest = size % 32 / 8;
+        std::uint64_t lane0 = kHashPrime1;
+        std::uint64_t lane1 = kHashPrime2;
+        std::uint64_t lane2 = ~kHashPrime1;
+        std::uint64_t lane3 = ~kHashPrime2;
+        for (std::size_t b = 0; b < kBlocks; ++b, bytes += 32) {
+            lane0 = HashCombine(lane0, LoadWord(bytes));
+            lane1 = HashCombine(lane1, LoadWord(bytes + 8));
+            lane2 = HashCombine(lane2, LoadWord(bytes + 16));
+            lane3 = HashCombine(lane3, LoadWord(bytes + 24));
+        }
+        if constexpr (kRest > 0) {
+            lane0 = HashCombine(lane0, LoadWord(bytes));
+        }
+        if constexpr (kRest > 1) {
+            lane1 = HashCombine(lane1, LoadWord(bytes + 8));
+        }
+        if constexpr (kRest > 2) {
+            lane2 = HashCombine(lane2, LoadWord(bytes + 16));
+        }
+        if constexpr (size % 8 != 0) {
+            std::uint64_t tail = 0;
+            std::memcpy(&tail, bytes + kRest * 8, size % 8);
+            lane3 = HashCombine(lane3, tail);
+        }
+        // Folding the lanes without a dependency chain keeps small keys cheap
+        std::uint64_t h = size * kHashPrime1 + lane0 + std::rotl(lane1, 7) +
+                          std::rotl(lane2, 12) + std::rotl(lane3, 18);
+        return HashAvalanche(h);
+    }
+
+    template <class T>
+    std::uint64_t HashObject(const T& object);
+
+    template <class T>
+    bool EqualObjects(const T& lhs, const T& rhs);
+
+    template <class U>
+    std::uint64_t HashValue(const U& value) {
+        if constexpr (kBytewise<U>) {
+            return HashBytes<sizeof(U)>(reinterpret_cast<const std::byte*>(&value));
+        } else if constexpr (requires { std::hash<U>{}(value); }) {
+            return HashAvalanche(std::hash<U>{}(value));
+        } else if constexpr (kIsHashArray<U>) {
+            std::uint64_t h = value.size();
+            for (const auto& element : value) {
+                h = HashCombine(h, HashValue(element));
+            }
+            return HashAvalanche(h);
+        } else {
+            static_assert(HashReflected<U>, "field type is not hashable");
+            return HashObject(value);
+        }
+    }
+
+    template <class U>
+    bool EqualValues(const U& lhs, const U& rhs) {
+        if constexpr (kBytewise<U>) {
+            return std::memcmp(&lhs, &rhs, sizeof(U)) == 0;
+        } else if constexpr (std::equality_comparable<U>) {
+            return lhs == rhs;
+        } else if constexpr (kIsHashArray<U>) {
+            for (std::size_t i = 0; i < lhs.size(); ++i) {
+                if (!EqualValues(lhs[i], rhs[i])) {
+                    return false;
+                }
+            }
+            return true;
+        } else {
+            static_assert(HashReflected<U>, "field type is not comparable");
+            return EqualObjects(lhs, rhs);
+        }
+    }
+
+    // NoHash fields are skipped at compile time, so their types need neither
+    // a hash nor an operator==
+    template <class T, std::size_t I>
+    std::uint64_t HashField(std::uint64_t h, const T& object) {
+        using D = Describe<T>;
+        if constexpr (D::template Field<I>::template has_annotation_class<NoHash>) {
+            return h;
+        } else {
+            return HashCombine(h, HashValue(D::template Get<I>(object)));
+        }
+    }
+
+    template <class T, std::size_t I>
+    bool EqualField(const T& lhs, const T& rhs) {
+        using D = Describe<T>;
+        if constexpr (D::template Field<I>::template has_annotation_class<NoHash>) {
+            return true;
+        } else {
+            return EqualValues(D::template Get<I>(lhs), D::template Get<I>(rhs));
+        }
+    }
+
+    template <class T, std::size_t... I>
+    std::uint64_t HashFields(const T& object, std::index_sequence<I...>) {
+        std::uint64_t h = kHashPrime1;
+        ((h = HashField<T, I>(h, object)), ...);
+        return HashAvalanche(h);
+    }
+
+    template <class T, std::size_t... I>
+    bool EqualFields(const T& lhs, const T& rhs, std::index_sequence<I...>) {
+        return (EqualField<T, I>(lhs, rhs) && ...);
+    }
+
+    template <class T>
+    std::uint64_t HashObject(const T& object) {
+        return HashFields(object, std::make_index_sequence<Describe<T>::num_fields>());
+    }
+
+    template <class T>
+    bool EqualObjects(const T& lhs, const T& rhs) {
+        return EqualFields(lhs, rhs, std::make_index_sequence<Describe<T>::num_fields>());
+    }
+
+} // namespace detail
+
+
+// Hash and equality functors for aggregates, usable as the Hash and KeyEqual
+// of unordered containers. When T is bytewise (see detail::kBytewiseObject) both
+// work on the object representation in a single pass; otherwise fields are
+// combined one by one, skipping Annotate<NoHash> ones. Members that are not
+// reflected aggregates use std::hash and operator==.
+template <class T> requires detail::HashReflected<T>
+struct ReflectHash {
+    std::size_t operator()(const T& object) const noexcept {
+        if constexpr (detail::kBytewiseObject<T>) {
+            return static_cast<std::size_t>(detail::HashBytes<sizeof(T)>(reinterpret_cast<const std::byte*>(&object)));
+        } else {
+            return static_cast<std::size_t>(detail::HashObject(object));
+        }
+    }
+};
+
+template <class T> requires detail::HashReflected<T>
+struct ReflectEqual {
+    bool operator()(const T& lhs, const T& rhs) const noexcept {
+        if constexpr (detail::kBytewiseObject<T>) {
+            return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+        } else {
+            return detail::EqualObjects(lhs, rhs);
+        }
+    }
+};
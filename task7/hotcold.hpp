@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "reflect.hpp"
+
+
+// Field annotations for HotColdStorage:
+//   Annotate<Hot>   the field goes to the densely packed hot records
+//   Annotate<Cold>  the field goes to the cold records; so does any field
+//                   without either annotation
+struct Hot {};
+struct Cold {};
+
+
+namespace detail {
+
+    // Indices of the fields of T with the given hotness, largest alignment
+    // first so that the record built from them has as little padding as
+    // a tuple allows
+    template <class T, bool hot>
+    consteval auto HotColdIndices() {
+        using D = Describe<T>;
+        constexpr std::size_t kCount = [] {
+            std::size_t count = 0;
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                ((count += D::template Field<I>::template has_annotation_class<Hot> == hot), ...);
+            }(std::make_index_sequence<D::num_fields>());
+            return count;
+        }();
+
+        std::array<std::size_t, kCount> indices{};
+        std::array<std::size_t, kCount> alignments{};
+        std::size_t next = 0;
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((D::template Field<I>::template has_annotation_class<Hot> == hot
+                  ? (alignments[next] = alignof(typename D::template Field<I>::Type), indices[next++] = I)
+                  : 0), ...);
+        }(std::make_index_sequence<D::num_fields>());
+
+        // Insertion sort, stable so equal alignments keep declaration order
+        for (std::size_t i = 1; i < kCount; ++i) {
+            for (std::size_t j = i; j > 0 && alignments[j - 1] < alignments[j]; --j) {
+                std::swap(alignments[j - 1], alignments[j]);
+                std::swap(indices[j - 1], indices[j]);
+            }
+        }
+        return indices;
+    }
+
+    template <class T, auto indices, class Sequence = std::make_index_sequence<indices.size()>>
+    struct SHotColdRecord;
+
+    template <class T, auto indices, std::size_t... J>
+    struct SHotColdRecord<T, indices, std::index_sequence<J...>> {
+        using Type = std::tuple<std::remove_cv_t<typename Describe<T>::template Field<indices[J]>::Type>...>;
+    };
+
+    // Position of field I in indices, indices.size() if absent
+    template <auto indices>
+    consteval std::size_t HotColdSlot(std::size_t field) {
+        return static_cast<std::size_t>(std::find(indices.begin(), indices.end(), field) - indices.begin());
+    }
+
+} // namespace detail
+
+
+// Rows of the aggregate T split by field hotness into two parallel arrays:
+// a loop that reads only Hot fields walks the small hot records and never
+// pulls the cold ones into cache. get<I> takes the Describe<T> field index
+// and finds the field in whichever array holds it.
+template <class T>
+class HotColdStorage {
+    using D = Describe<T>;
+
+    static constexpr auto hot_indices_ = detail::HotColdIndices<T, true>();
+    static constexpr auto cold_indices_ = detail::HotColdIndices<T, false>();
+
+ public:
+    using HotRecord = typename detail::SHotColdRecord<T, hot_indices_>::Type;
+    using ColdRecord = typename detail::SHotColdRecord<T, cold_indices_>::Type;
+
+    template <std::size_t I>
+    static constexpr bool is_hot = D::template Field<I>::template has_annotation_class<Hot>;
+
+    // One row, behaving like a T whose fields are reached through get<I>
+    template <bool is_const>
+    class Reference {
+        using Storage = std::conditional_t<is_const, const HotColdStorage, HotColdStorage>;
+
+     public:
+        Reference(Storage& storage, std::size_t row) : storage_(&storage), row_(row) {}
+
+        template <std::size_t I>
+        decltype(auto) get() const {
+            return storage_->template get<I>(row_);
+        }
+
+        operator T() const {
+            return storage_->Load(row_);
+        }
+
+        const Reference& operator=(const T& value) const requires (!is_const) {
+            storage_->Store(row_, value);
+            return *this;
+        }
+
+        template <std::size_t I>
+        friend decltype(auto) get(const Reference& reference) {
+            return reference.template get<I>();
+        }
+
+     private:
+        Storage* storage_;
+        std::size_t row_;
+    };
+
+    std::size_t Size() const noexcept {
+        return hot_.size();
+    }
+
+    void Reserve(std::size_t rows) {
+        hot_.reserve(rows);
+        cold_.reserve(rows);
+    }
+
+    void Clear() noexcept {
+        hot_.clear();
+        cold_.clear();
+    }
+
+    void PushBack(const T& value) {
+        hot_.emplace_back();
+        cold_.emplace_back();
+        Store(Size() - 1, value);
+    }
+
+    template <std::size_t I>
+    auto& get(std::size_t row) {
+        assert(row < Size());
+        if constexpr (is_hot<I>) {
+            return std::get<detail::HotColdSlot<hot_indices_>(I)>(hot_[row]);
+        } else {
+            return std::get<detail::HotColdSlot<cold_indices_>(I)>(cold_[row]);
+        }
+    }
+
+    template <std::size_t I>
+    const auto& get(std::size_t row) const {
+        assert(row < Size());
+        if constexpr (is_hot<I>) {
+            return std::get<detail::HotColdSlot<hot_indices_>(I)>(hot_[row]);
+        } else {
+            return std::get<detail::HotColdSlot<cold_indices_>(I)>(cold_[row]);
+        }
+    }
+
+    Reference<false> operator[](std::size_t row) {
+        assert(row < Size());
+        return {*this, row};
+    }
+
+    Reference<true> operator[](std::size_t row) const {
+        assert(row < Size());
+        return {*this, row};
+    }
+
+    // Reassembles row into a T, which must be default constructible
+    T Load(std::size_t row) const {
+        T value{};
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((D::template Get<I>(value) = get<I>(row)), ...);
+        }(std::make_index_sequence<D::num_fields>());
+        return value;
+    }
+
+    void Store(std::size_t row, const T& value) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((get<I>(row) = D::template Get<I>(value)), ...);
+        }(std::make_index_sequence<D::num_fields>());
+    }
+
+    // The hot records alone, for loops that only need hot fields
+    const std::vector<HotRecord>& HotRecords() const noexcept {
+        return hot_;
+    }
+
+ private:
+    std::vector<HotRecord> hot_;
+    std::vector<ColdRecord> cold_;
+};
@@ -0,0 +1,574 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "reflect.hpp"
+#include "../task4/FixedString.hpp"
+
+
+// Field annotation naming the JSON key of the field declared after it:
+//   Annotate<JsonName<"price"_cstr>> _;
+//   double price;
+// ParseJson reads only named fields; the others keep their values. Keys of
+// the input that name no field are skipped without being validated.
+template <FixedString<256> name>
+struct JsonName {
+    static constexpr std::string_view value = name;
+};
+
+
+namespace detail {
+
+    template <class Annotations>
+    inline constexpr std::string_view kJsonNameOf{};
+
+    template <class Head, class... Tail>
+    inline constexpr std::string_view kJsonNameOf<Annotate<Head, Tail...>> = kJsonNameOf<Annotate<Tail...>>;
+
+    template <FixedString<256> name, class... Tail>
+    inline constexpr std::string_view kJsonNameOf<Annotate<JsonName<name>, Tail...>> = JsonName<name>::value;
+
+    template <class U>
+    inline constexpr bool kIsJsonArray = false;
+
+    template <class E, std::size_t N>
+    inline constexpr bool kIsJsonArray<std::array<E, N>> = true;
+
+    template <class U>
+    inline constexpr bool kIsJsonVector = false;
+
+    template <class E, class A>
+    inline constexpr bool kIsJsonVector<std::vector<E, A>> = true;
+
+    template <class U>
+    inline constexpr bool kIsJsonOptional = false;
+
+    template <class E>
+    inline constexpr bool kIsJsonOptional<std::optional<E>> = true;
+
+    template <class U>
+    concept JsonReflected = std::is_aggregate_v<U> && !std::is_array_v<U> && !kIsJsonArray<U>;
+
+    // Key names of the fields of T, empty for fields without JsonName
+    template <class T>
+    inline constexpr auto kJsonNames = [] {
+        using D = Describe<T>;
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return std::array<std::string_view, D::num_fields>{
+                kJsonNameOf<typename D::template Field<I>::Annotations>...};
+        }(std::make_index_sequence<D::num_fields>());
+    }();
+
+    constexpr std::uint64_t JsonKeyHash(std::string_view key, std::uint64_t seed) {
+        std::uint64_t hash = seed ^ key.size();
+        for (char c : key) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+        }
+        return hash ^ (hash >> 29);
+    }
+
+    struct JsonKeyShape {
+        std::uint64_t seed = 0;
+        std::size_t bits = 0;
+    };
+
+    // Not constexpr, so reaching it during constant evaluation stops the
+    // compilation with the message in the diagnostic
+    inline void JsonKeyShapeError(const char* /*message*/) {}
+
+    template <std::size_t N>
+    constexpr bool JsonNamesUnique(const std::array<std::string_view, N>& names) {
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t j = 0; j < i; ++j) {
+                if (!names[i].empty() && names[i] == names[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Largest table tried, relative to the smallest one
+    inline constexpr std::size_t kJsonKeyExtraBits = 4;
+
+    // Smallest table, at least twice the number of keys, and a seed for
+    // which no two keys of T share a slot
+    template <class T>
+    inline constexpr JsonKeyShape kJsonKeyShape = [] {
+        constexpr auto& names = kJsonNames<T>;
+        static_assert(JsonNamesUnique(names), "two fields have the same JsonName");
+        if constexpr (!JsonNamesUnique(names)) {
+            return JsonKeyShape{};
+        }
+        std::size_t keys = 0;
+        for (auto name : names) {
+            keys += !name.empty();
+        }
+        std::size_t min_bits = keys == 0 ? 0 : std::bit_width(keys);
+        for (std::size_t bits = min_bits; bits <= min_bits + kJsonKeyExtraBits; ++bits) {
+            for (std::uint64_t seed = 1; seed <= 4096; ++seed) {
+                std::array<std::size_t, names.size()> slots{};
+                bool collides = false;
+                for (std::size_t i = 0; i < names.size() && !collides; ++i) {
+                    if (names[i].empty()) {
+                        continue;
+                    }
+                    slots[i] = JsonKeyHash(names[i], seed) & ((std::size_t{1} << bits) - 1);
+                    for (std::size_t j = 0; j < i; ++j) {
+                        collides = collides || (!names[j].empty() && slots[j] == slots[i]);
+                    }
+                }
+                if (!collides) {
+                    return JsonKeyShape{seed, bits};
+                }
+            }
+        }
+        JsonKeyShapeError("json: no seed separates the keys of T");
+        return JsonKeyShape{};
+    }();
+
+    // Slot -> field index + 1, 0 for empty slots
+    template <class T>
+    inline constexpr auto kJsonKeys = [] {
+        constexpr auto& names = kJsonNames<T>;
+        constexpr JsonKeyShape shape = kJsonKeyShape<T>;
+        std::array<std::uint16_t, std::size_t{1} << shape.bits> slots{};
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            if (!names[i].empty()) {
+                slots[JsonKeyHash(names[i], shape.seed) & (slots.size() - 1)] = static_cast<std::uint16_t>(i + 1);
+            }
+        }
+        return slots;
+    }();
+
+    inline constexpr std::size_t kNoJsonField = ~std::size_t{0};
+
+    template <class T>
+    std::size_t FindJsonField(std::string_view key) {
+        constexpr auto& slots = kJsonKeys<T>;
+        std::size_t field = slots[JsonKeyHash(key, kJsonKeyShape<T>.seed) & (slots.size() - 1)];
+        if (field == 0 || kJsonNames<T>[field - 1] != key) {
+            return kNoJsonField;
+        }
+        return field - 1;
+    }
+
+    inline constexpr std::uint64_t kJsonOnes = 0x0101010101010101ull;
+
+    // High bit set in every byte of word equal to c. Bits above a match may
+    // be set spuriously, the lowest one is always right
+    constexpr std::uint64_t JsonBytesEqual(std::uint64_t word, char c) {
+        std::uint64_t v = word ^ (kJsonOnes * static_cast<unsigned char>(c));
+        return (v - kJsonOnes) & ~v & (kJsonOnes << 7);
+    }
+
+    // Scans eight bytes at a time for the first byte that mask() flags;
+    // the SWAR path needs the lowest memory byte in the lowest bits
+    template <class Mask, class Scalar>
+    const char* JsonScan(const char* pos, const char* end, Mask mask, Scalar scalar) {
+        if constexpr (std::endian::native == std::endian::little) {
+            while (end - pos >= 8) {
+                std::uint64_t word;
+                std::memcpy(&word, pos, 8);
+                if (std::uint64_t found = mask(word)) {
+                    return pos + std::countr_zero(found) / 8;
+                }
+                pos += 8;
+            }
+        }
+        while (pos != end && !scalar(*pos)) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    // Appends the UTF-8 encoding of code_point; returns the new end
+    inline char* PutUtf8(char* out, std::uint32_t code_point) {
+        if (code_point < 0x80) {
+            *out++ = static_cast<char>(code_point);
+        } else if (code_point < 0x800) {
+            *out++ = static_cast<char>(0xc0 | (code_point >> 6));
+            *out++ = static_cast<char>(0x80 | (code_point & 0x3f));
+        } else if (code_point < 0x10000) {
+            *out++ = static_cast<char>(0xe0 | (code_point >> 12));
+            *out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+            *out++ = static_cast<char>(0x80 | (code_point & 0x3f));
+        } else {
+            *out++ = static_cast<char>(0xf0 | (code_point >> 18));
+            *out++ = static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+            *out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+            *out++ = static_cast<char>(0x80 | (code_point & 0x3f));
+        }
+        return out;
+    }
+
+    inline bool ReadHex4(const char* pos, std::uint32_t& value) {
+        auto [ptr, ec] = std::from_chars(pos, pos + 4, value, 16);
+        return ec == std::errc{} && ptr == pos + 4;
+    }
+
+    // Decodes the body of a string with escapes into out, which needs
+    // raw.size() bytes; returns the decoded size, nothing if malformed
+    inline std::optional<std::size_t> UnescapeJson(std::string_view raw, char* out) {
+        char* start = out;
+        const char* pos = raw.data();
+        const char* end = pos + raw.size();
+        while (pos != end) {
+            const char* escape = static_cast<const char*>(std::memchr(pos, '\\', end - pos));
+            if (escape == nullptr) {
+                escape = end;
+            }
+            std::memcpy(out, pos, escape - pos);
+            out += escape - pos;
+            pos = escape;
+            if (pos == end) {
+                break;
+            }
+            if (end - pos < 2) {
+                return std::nullopt;
+            }
+            switch (pos[1]) {
+                case '"': *out++ = '"'; break;
+                case '\\': *out++ = '\\'; break;
+                case '/': *out++ = '/'; break;
+                case 'b': *out++ = '\b'; break;
+                case 'f': *out++ = '\f'; break;
+                case 'n': *out++ = '\n'; break;
+                case 'r': *out++ = '\r'; break;
+                case 't': *out++ = '\t'; break;
+                case 'u': {
+                    std::uint32_t code_point;
+                    if (end - pos < 6 || !ReadHex4(pos + 2, code_point)) {
+                        return std::nullopt;
+                    }
+                    if (code_point >= 0xd800 && code_point < 0xdc00) {
+                        std::uint32_t low;
+                        if (end - pos < 12 || pos[6] != '\\' || pos[7] != 'u' || !ReadHex4(pos + 8, low) ||
+                            low < 0xdc00 || low >= 0xe000) {
+                            return std::nullopt;
+                        }
+                        code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low - 0xdc00);
+                        pos += 6;
+                    }
+                    out = PutUtf8(out, code_point);
+                    pos += 4;
+                    break;
+                }
+                default:
+                    return std::nullopt;
+            }
+            pos += 2;
+        }
+        return static_cast<std::size_t>(out - start);
+    }
+
+    class JsonReader {
+     public:
+        explicit JsonReader(std::string_view json) : pos_(json.data()), end_(json.data() + json.size()) {}
+
+        const char* Position() const {
+            return pos_;
+        }
+
+        // Next non-whitespace character, not consumed; '\0' at the end
+        char Peek() {
+            while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t')) {
+                ++pos_;
+            }
+            return pos_ == end_ ? '\0' : *pos_;
+        }
+
+        bool Consume(char c) {
+            if (Peek() != c) {
+                return false;
+            }
+            ++pos_;
+            return true;
+        }
+
+        bool ConsumeWord(std::string_view word) {
+            Peek();
+            if (static_cast<std::size_t>(end_ - pos_) < word.size() || std::memcmp(pos_, word.data(), word.size()) != 0) {
+                return false;
+            }
+            pos_ += word.size();
+            return true;
+        }
+
+        // Body of the next string, escapes left in; escaped tells whether
+        // there are any
+        bool ReadRawString(std::string_view& raw, bool& escaped) {
+            if (!Consume('"')) {
+                return false;
+            }
+            const char* start = pos_;
+            escaped = false;
+            while (true) {
+                pos_ = JsonScan(pos_, end_,
+                    [](std::uint64_t word) { return JsonBytesEqual(word, '"') | JsonBytesEqual(word, '\\'); },
+                    [](char c) { return c == '"' || c == '\\'; });
+                if (pos_ == end_) {
+                    return false;
+                }
+                if (*pos_ == '"') {
+                    break;
+                }
+                escaped = true;
+                if (end_ - pos_ < 2) {
+                    return false;
+                }
+                pos_ += 2;
+            }
+            raw = std::string_view(start, pos_ - start);
+            ++pos_;
+            return true;
+        }
+
+        // The number, literal or string that starts here, as text
+        bool ReadToken(std::string_view& token) {
+            Peek();
+            const char* start = pos_;
+            while (pos_ != end_ && *pos_ != ',' && *pos_ != '}' && *pos_ != ']' && *pos_ != ' ' &&
+                   *pos_ != '\n' && *pos_ != '\r' && *pos_ != '\t') {
+                ++pos_;
+            }
+            token = std::string_view(start, pos_ - start);
+            return !token.empty();
+        }
+
+        // Skips one value. Only strings and bracket nesting are tracked;
+        // nothing is validated
+        bool SkipValue() {
+            char c = Peek();
+            if (c == '"') {
+                std::string_view raw;
+                bool escaped;
+                return ReadRawString(raw, escaped);
+            }
+            if (c != '{' && c != '[') {
+                std::string_view token;
+                return ReadToken(token);
+            }
+            std::size_t depth = 0;
+            while (true) {
+                // '[' and ']' differ from '{' and '}' only in bit 0x20
+                pos_ = JsonScan(pos_, end_,
+                    [](std::uint64_t word) {
+                        std::uint64_t folded = word | (kJsonOnes * 0x20);
+                        return JsonBytesEqual(word, '"') | JsonBytesEqual(folded, '{') | JsonBytesEqual(folded, '}');
+                    },
+                    [](char c) { return c == '"' || c == '{' || c == '}' || c == '[' || c == ']'; });
+                if (pos_ == end_) {
+                    return false;
+                }
+                if (*pos_ == '"') {
+                    std::string_view raw;
+                    bool escaped;
+                    if (!ReadRawString(raw, escaped)) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (*pos_ == '{' || *pos_ == '[') {
+                    ++depth;
+                } else if (--depth == 0) {
+                    ++pos_;
+                    return true;
+                }
+                ++pos_;
+            }
+        }
+
+     private:
+        const char* pos_;
+        const char* end_;
+    };
+
+    // Whether token follows the JSON number grammar,
+    // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?, which from_chars is
+    // looser than: it also takes nan, inf, 1. and leading zeros
+    constexpr bool IsJsonNumber(std::string_view token) {
+        std::size_t pos = 0;
+        auto digits = [&] {
+            std::size_t start = pos;
+            while (pos < token.size() && token[pos] >= '0' && token[pos] <= '9') {
+                ++pos;
+            }
+            return pos - start;
+        };
+        if (pos < token.size() && token[pos] == '-') {
+            ++pos;
+        }
+        std::size_t first = pos;
+        std::size_t integral = digits();
+        if (integral == 0 || (integral > 1 && token[first] == '0')) {
+            return false;
+        }
+        if (pos < token.size() && token[pos] == '.') {
+            ++pos;
+            if (digits() == 0) {
+                return false;
+            }
+        }
+        if (pos < token.size() && (token[pos] == 'e' || token[pos] == 'E')) {
+            ++pos;
+            if (pos < token.size() && (token[pos] == '+' || token[pos] == '-')) {
+                ++pos;
+            }
+            if (digits() == 0) {
+                return false;
+            }
+        }
+        return pos == token.size();
+    }
+
+    template <class T>
+    bool ReadJsonObject(JsonReader& in, T& object);
+
+    template <class U>
+    bool ReadJsonValue(JsonReader& in, U& value) {
+        if constexpr (std::is_same_v<U, bool>) {
+            bool is_true = in.ConsumeWord("true");
+            if (!is_true && !in.ConsumeWord("false")) {
+                return false;
+            }
+            value = is_true;
+            return true;
+        } else if constexpr (std::is_enum_v<U>) {
+            std::underlying_type_t<U> raw;
+            if (!ReadJsonValue(in, raw)) {
+                return false;
+            }
+            value = static_cast<U>(raw);
+            return true;
+        } else if constexpr (std::is_arithmetic_v<U>) {
+            std::string_view token;
+            if (!in.ReadToken(token) || !IsJsonNumber(token)) {
+                return false;
+            }
+            auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+            return ec == std::errc{} && ptr == token.data() + token.size();
+        } else if constexpr (std::is_same_v<U, std::string_view>) {
+            // Points into the input, so there is nowhere to put unescaped text
+            bool escaped;
+            return in.ReadRawString(value, escaped) && !escaped;
+        } else if constexpr (std::is_same_v<U, std::string>) {
+            std::string_view raw;
+            bool escaped;
+            if (!in.ReadRawString(raw, escaped)) {
+                return false;
+            }
+            if (!escaped) {
+                value.assign(raw);
+                return true;
+            }
+            value.resize(raw.size());
+            auto size = UnescapeJson(raw, value.data());
+            if (!size) {
+                return false;
+            }
+            value.resize(*size);
+            return true;
+        } else if constexpr (kIsJsonOptional<U>) {
+            if (in.ConsumeWord("null")) {
+                value.reset();
+                return true;
+            }
+            return ReadJsonValue(in, value.emplace());
+        } else if constexpr (kIsJsonArray<U>) {
+            if (!in.Consume('[')) {
+                return false;
+            }
+            for (std::size_t i = 0; i < value.size(); ++i) {
+                if ((i != 0 && !in.Consume(',')) || !ReadJsonValue(in, value[i])) {
+                    return false;
+                }
+            }
+            return in.Consume(']');
+        } else if constexpr (kIsJsonVector<U>) {
+            value.clear();
+            if (!in.Consume('[')) {
+                return false;
+            }
+            if (in.Consume(']')) {
+                return true;
+            }
+            do {
+                if (!ReadJsonValue(in, value.emplace_back())) {
+                    return false;
+                }
+            } while (in.Consume(','));
+            return in.Consume(']');
+        } else {
+            static_assert(JsonReflected<U>, "field type cannot be read from JSON");
+            return ReadJsonObject(in, value);
+        }
+    }
+
+    template <class T>
+    bool ReadJsonField(JsonReader& in, T& object, std::size_t field) {
+        using D = Describe<T>;
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            bool read = false;
+            ((field == I && (read = ReadJsonValue(in, D::template Get<I>(object)), true)) || ...);
+            return read;
+        }(std::make_index_sequence<D::num_fields>());
+    }
+
+    // Longest key decoded on the stack; longer keys with escapes match no field
+    inline constexpr std::size_t kJsonKeyBuffer = 256;
+
+    template <class T>
+    bool ReadJsonObject(JsonReader& in, T& object) {
+        if (!in.Consume('{')) {
+            return false;
+        }
+        if (in.Consume('}')) {
+            return true;
+        }
+        do {
+            std::string_view key;
+            bool escaped;
+            if (!in.ReadRawString(key, escaped) || !in.Consume(':')) {
+                return false;
+            }
+            char buffer[kJsonKeyBuffer];
+            if (escaped) {
+                auto size = key.size() <= kJsonKeyBuffer ? UnescapeJson(key, buffer) : std::nullopt;
+                key = size ? std::string_view(buffer, *size) : std::string_view();
+            }
+            std::size_t field = key.empty() ? kNoJsonField : FindJsonField<T>(key);
+            if (!(field == kNoJsonField ? in.SkipValue() : ReadJsonField(in, object, field))) {
+                return false;
+            }
+        } while (in.Consume(','));
+        return in.Consume('}');
+    }
+
+} // namespace detail
+
+
+// Reads the JSON object at the start of json into the fields of object
+// annotated with JsonName, with no intermediate document. Returns the number
+// of characters consumed, nothing if json is malformed or a value does not
+// fit its field. Only std::string and std::vector fields allocate;
+// string_view fields point into json and reject strings with escapes.
+template <class T> requires detail::JsonReflected<T>
+std::optional<std::size_t> ParseJson(T& object, std::string_view json) {
+    detail::JsonReader reader(json);
+    if (!detail::ReadJsonObject(reader, object)) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(reader.Position() - json.data());
+}
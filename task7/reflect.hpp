@@ -1,29 +1,773 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 
 template <class...>
 class Annotate {};
 
-struct /* unspecified (field descriptor) */ {
-    using Type = /* ... */;
-    using Annotations = Annotate</* ... */>;
 
-    template <template <class...> class AnnotationTemplate>
-    static constexpr bool has_annotation_template = /* ... */;
-    
+namespace detail {
+
+    // Converts to any field type, so T{AnyField{}...} compiles exactly when
+    // T has at least that many fields
+    struct AnyField {
+        template <class U>
+        operator U() const noexcept;
+    };
+
+    template <class T, std::size_t... I>
+    constexpr bool IsBraceConstructible(std::index_sequence<I...>) {
+        return requires { T{((void)I, AnyField{})...}; };
+    }
+
+    template <class T, std::size_t n>
+    inline constexpr bool kFitsFields = IsBraceConstructible<T>(std::make_index_sequence<n>());
+
+    // kFitsFields<T, lo> holds, kFitsFields<T, hi> does not
+    template <class T, std::size_t lo, std::size_t hi>
+    consteval std::size_t SearchRawFields() {
+        if constexpr (hi - lo <= 1) {
+            return lo;
+        } else if constexpr (kFitsFields<T, lo + (hi - lo) / 2>) {
+            return SearchRawFields<T, lo + (hi - lo) / 2, hi>();
+        } else {
+            return SearchRawFields<T, lo, lo + (hi - lo) / 2>();
+        }
+    }
+
+    // Doubles n until T no longer fits, then binary searches the last step:
+    // O(log fields) probes instead of one per field
+    template <class T, std::size_t n = 1>
+    consteval std::size_t CountRawFields() {
+        if constexpr (kFitsFields<T, n>) {
+            return CountRawFields<T, n * 2>();
+        } else {
+            return SearchRawFields<T, n / 2, n>();
+        }
+    }
+
+    template <class... Ts>
+    struct RawFields {};
+
+    inline constexpr std::size_t kMaxRawFields = 256;
+
+#define REFLECT_BINDINGS_1 f0
+#define REFLECT_BINDINGS_2 REFLECT_BINDINGS_1, f1
+#define REFLECT_BINDINGS_3 REFLECT_BINDINGS_2, f2
+#define REFLECT_BINDINGS_4 REFLECT_BINDINGS_3, f3
+#define REFLECT_BINDINGS_5 REFLECT_BINDINGS_4, f4
+#define REFLECT_BINDINGS_6 REFLECT_BINDINGS_5, f5
+#define REFLECT_BINDINGS_7 REFLECT_BINDINGS_6, f6
+#define REFLECT_BINDINGS_8 REFLECT_BINDINGS_7, f7
+#define REFLECT_BINDINGS_9 REFLECT_BINDINGS_8, f8
+#define REFLECT_BINDINGS_10 REFLECT_BINDINGS_9, f9
+#define REFLECT_BINDINGS_11 REFLECT_BINDINGS_10, f10
+#define REFLECT_BINDINGS_12 REFLECT_BINDINGS_11, f11
+#define REFLECT_BINDINGS_13 REFLECT_BINDINGS_12, f12
+#define REFLECT_BINDINGS_14 REFLECT_BINDINGS_13, f13
+#define REFLECT_BINDINGS_15 REFLECT_BINDINGS_14, f14
+#define REFLECT_BINDINGS_16 REFLECT_BINDINGS_15, f15
+#define REFLECT_BINDINGS_17 REFLECT_BINDINGS_16, f16
+#define REFLECT_BINDINGS_18 REFLECT_BINDINGS_17, f17
+#define REFLECT_BINDINGS_19 REFLECT_BINDINGS_18, f18
+#define REFLECT_BINDINGS_20 REFLECT_BINDINGS_19, f19
+#define REFLECT_BINDINGS_21 REFLECT_BINDINGS_20, f20
+#define REFLECT_BINDINGS_22 REFLECT_BINDINGS_21, f21
+#define REFLECT_BINDINGS_23 REFLECT_BINDINGS_22, f22
+#define REFLECT_BINDINGS_24 REFLECT_BINDINGS_23, f23
+#define REFLECT_BINDINGS_25 REFLECT_BINDINGS_24, f24
+#define REFLECT_BINDINGS_26 REFLECT_BINDINGS_25, f25
+#define REFLECT_BINDINGS_27 REFLECT_BINDINGS_26, f26
+#define REFLECT_BINDINGS_28 REFLECT_BINDINGS_27, f27
+#define REFLECT_BINDINGS_29 REFLECT_BINDINGS_28, f28
+#define REFLECT_BINDINGS_30 REFLECT_BINDINGS_29, f29
+#define REFLECT_BINDINGS_31 REFLECT_BINDINGS_30, f30
+#define REFLECT_BINDINGS_32 REFLECT_BINDINGS_31, f31
+#define REFLECT_BINDINGS_33 REFLECT_BINDINGS_32, f32
+#define REFLECT_BINDINGS_34 REFLECT_BINDINGS_33, f33
+#define REFLECT_BINDINGS_35 REFLECT_BINDINGS_34, f34
+#define REFLECT_BINDINGS_36 REFLECT_BINDINGS_35, f35
+#define REFLECT_BINDINGS_37 REFLECT_BINDINGS_36, f36
+#define REFLECT_BINDINGS_38 REFLECT_BINDINGS_37, f37
+#define REFLECT_BINDINGS_39 REFLECT_BINDINGS_38, f38
+#define REFLECT_BINDINGS_40 REFLECT_BINDINGS_39, f39
+#define REFLECT_BINDINGS_41 REFLECT_BINDINGS_40, f40
+#define REFLECT_BINDINGS_42 REFLECT_BINDINGS_41, f41
+#define REFLECT_BINDINGS_43 REFLECT_BINDINGS_42, f42
+#define REFLECT_BINDINGS_44 REFLECT_BINDINGS_43, f43
+#define REFLECT_BINDINGS_45 REFLECT_BINDINGS_44, f44
+#define REFLECT_BINDINGS_46 REFLECT_BINDINGS_45, f45
+#define REFLECT_BINDINGS_47 REFLECT_BINDINGS_46, f46
+#define REFLECT_BINDINGS_48 REFLECT_BINDINGS_47, f47
+#define REFLECT_BINDINGS_49 REFLECT_BINDINGS_48, f48
+#define REFLECT_BINDINGS_50 REFLECT_BINDINGS_49, f49
+#define REFLECT_BINDINGS_51 REFLECT_BINDINGS_50, f50
+#define REFLECT_BINDINGS_52 REFLECT_BINDINGS_51, f51
+#define REFLECT_BINDINGS_53 REFLECT_BINDINGS_52, f52
+#define REFLECT_BINDINGS_54 REFLECT_BINDINGS_53, f53
+#define REFLECT_BINDINGS_55 REFLECT_BINDINGS_54, f54
+#define REFLECT_BINDINGS_56 REFLECT_BINDINGS_55, f55
+#define REFLECT_BINDINGS_57 REFLECT_BINDINGS_56, f56
+#define REFLECT_BINDINGS_58 REFLECT_BINDINGS_57, f57
+#define REFLECT_BINDINGS_59 REFLECT_BINDINGS_58, f58
+#define REFLECT_BINDINGS_60 REFLECT_BINDINGS_59, f59
+#define REFLECT_BINDINGS_61 REFLECT_BINDINGS_60, f60
+#define REFLECT_BINDINGS_62 REFLECT_BINDINGS_61, f61
+#define REFLECT_BINDINGS_63 REFLECT_BINDINGS_62, f62
+#define REFLECT_BINDINGS_64 REFLECT_BINDINGS_63, f63
+#define REFLECT_BINDINGS_65 REFLECT_BINDINGS_64, f64
+#define REFLECT_BINDINGS_66 REFLECT_BINDINGS_65, f65
+#define REFLECT_BINDINGS_67 REFLECT_BINDINGS_66, f66
+#define REFLECT_BINDINGS_68 REFLECT_BINDINGS_67, f67
+#define REFLECT_BINDINGS_69 REFLECT_BINDINGS_68, f68
+#define REFLECT_BINDINGS_70 REFLECT_BINDINGS_69, f69
+#define REFLECT_BINDINGS_71 REFLECT_BINDINGS_70, f70
+#define REFLECT_BINDINGS_72 REFLECT_BINDINGS_71, f71
+#define REFLECT_BINDINGS_73 REFLECT_BINDINGS_72, f72
+#define REFLECT_BINDINGS_74 REFLECT_BINDINGS_73, f73
+#define REFLECT_BINDINGS_75 REFLECT_BINDINGS_74, f74
+#define REFLECT_BINDINGS_76 REFLECT_BINDINGS_75, f75
+#define REFLECT_BINDINGS_77 REFLECT_BINDINGS_76, f76
+#define REFLECT_BINDINGS_78 REFLECT_BINDINGS_77, f77
+#define REFLECT_BINDINGS_79 REFLECT_BINDINGS_78, f78
+#define REFLECT_BINDINGS_80 REFLECT_BINDINGS_79, f79
+#define REFLECT_BINDINGS_81 REFLECT_BINDINGS_80, f80
+#define REFLECT_BINDINGS_82 REFLECT_BINDINGS_81, f81
+#define REFLECT_BINDINGS_83 REFLECT_BINDINGS_82, f82
+#define REFLECT_BINDINGS_84 REFLECT_BINDINGS_83, f83
+#define REFLECT_BINDINGS_85 REFLECT_BINDINGS_84, f84
+#define REFLECT_BINDINGS_86 REFLECT_BINDINGS_85, f85
+#define REFLECT_BINDINGS_87 REFLECT_BINDINGS_86, f86
+#define REFLECT_BINDINGS_88 REFLECT_BINDINGS_87, f87
+#define REFLECT_BINDINGS_89 REFLECT_BINDINGS_88, f88
+#define REFLECT_BINDINGS_90 REFLECT_BINDINGS_89, f89
+#define REFLECT_BINDINGS_91 REFLECT_BINDINGS_90, f90
+#define REFLECT_BINDINGS_92 REFLECT_BINDINGS_91, f91
+#define REFLECT_BINDINGS_93 REFLECT_BINDINGS_92, f92
+#define REFLECT_BINDINGS_94 REFLECT_BINDINGS_93, f93
+#define REFLECT_BINDINGS_95 REFLECT_BINDINGS_94, f94
+#define REFLECT_BINDINGS_96 REFLECT_BINDINGS_95, f95
+#define REFLECT_BINDINGS_97 REFLECT_BINDINGS_96, f96
+#define REFLECT_BINDINGS_98 REFLECT_BINDINGS_97, f97
+#define REFLECT_BINDINGS_99 REFLECT_BINDINGS_98, f98
+#define REFLECT_BINDINGS_100 REFLECT_BINDINGS_99, f99
+#define REFLECT_BINDINGS_101 REFLECT_BINDINGS_100, f100
+#define REFLECT_BINDINGS_102 REFLECT_BINDINGS_101, f101
+#define REFLECT_BINDINGS_103 REFLECT_BINDINGS_102, f102
+#define REFLECT_BINDINGS_104 REFLECT_BINDINGS_103, f103
+#define REFLECT_BINDINGS_105 REFLECT_BINDINGS_104, f104
+#define REFLECT_BINDINGS_106 REFLECT_BINDINGS_105, f105
+#define REFLECT_BINDINGS_107 REFLECT_BINDINGS_106, f106
+#define REFLECT_BINDINGS_108 REFLECT_BINDINGS_107, f107
+#define REFLECT_BINDINGS_109 REFLECT_BINDINGS_108, f108
+#define REFLECT_BINDINGS_110 REFLECT_BINDINGS_109, f109
+#define REFLECT_BINDINGS_111 REFLECT_BINDINGS_110, f110
+#define REFLECT_BINDINGS_112 REFLECT_BINDINGS_111, f111
+#define REFLECT_BINDINGS_113 REFLECT_BINDINGS_112, f112
+#define REFLECT_BINDINGS_114 REFLECT_BINDINGS_113, f113
+#define REFLECT_BINDINGS_115 REFLECT_BINDINGS_114, f114
+#define REFLECT_BINDINGS_116 REFLECT_BINDINGS_115, f115
+#define REFLECT_BINDINGS_117 REFLECT_BINDINGS_116, f116
+#define REFLECT_BINDINGS_118 REFLECT_BINDINGS_117, f117
+#define REFLECT_BINDINGS_119 REFLECT_BINDINGS_118, f118
+#define REFLECT_BINDINGS_120 REFLECT_BINDINGS_119, f119
+#define REFLECT_BINDINGS_121 REFLECT_BINDINGS_120, f120
+#define REFLECT_BINDINGS_122 REFLECT_BINDINGS_121, f121
+#define REFLECT_BINDINGS_123 REFLECT_BINDINGS_122, f122
+#define REFLECT_BINDINGS_124 REFLECT_BINDINGS_123, f123
+#define REFLECT_BINDINGS_125 REFLECT_BINDINGS_124, f124
+#define REFLECT_BINDINGS_126 REFLECT_BINDINGS_125, f125
+#define REFLECT_BINDINGS_127 REFLECT_BINDINGS_126, f126
+#define REFLECT_BINDINGS_128 REFLECT_BINDINGS_127, f127
+#define REFLECT_BINDINGS_129 REFLECT_BINDINGS_128, f128
+#define REFLECT_BINDINGS_130 REFLECT_BINDINGS_129, f129
+#define REFLECT_BINDINGS_131 REFLECT_BINDINGS_130, f130
+#define REFLECT_BINDINGS_132 REFLECT_BINDINGS_131, f131
+#define REFLECT_BINDINGS_133 REFLECT_BINDINGS_132, f132
+#define REFLECT_BINDINGS_134 REFLECT_BINDINGS_133, f133
+#define REFLECT_BINDINGS_135 REFLECT_BINDINGS_134, f134
+#define REFLECT_BINDINGS_136 REFLECT_BINDINGS_135, f135
+#define REFLECT_BINDINGS_137 REFLECT_BINDINGS_136, f136
+#define REFLECT_BINDINGS_138 REFLECT_BINDINGS_137, f137
+#define REFLECT_BINDINGS_139 REFLECT_BINDINGS_138, f138
+#define REFLECT_BINDINGS_140 REFLECT_BINDINGS_139, f139
+#define REFLECT_BINDINGS_141 REFLECT_BINDINGS_140, f140
+#define REFLECT_BINDINGS_142 REFLECT_BINDINGS_141, f141
+#define REFLECT_BINDINGS_143 REFLECT_BINDINGS_142, f142
+#define REFLECT_BINDINGS_144 REFLECT_BINDINGS_143, f143
+#define REFLECT_BINDINGS_145 REFLECT_BINDINGS_144, f144
+#define REFLECT_BINDINGS_146 REFLECT_BINDINGS_145, f145
+#define REFLECT_BINDINGS_147 REFLECT_BINDINGS_146, f146
+#define REFLECT_BINDINGS_148 REFLECT_BINDINGS_147, f147
+#define REFLECT_BINDINGS_149 REFLECT_BINDINGS_148, f148
+#define REFLECT_BINDINGS_150 REFLECT_BINDINGS_149, f149
+#define REFLECT_BINDINGS_151 REFLECT_BINDINGS_150, f150
+#define REFLECT_BINDINGS_152 REFLECT_BINDINGS_151, f151
+#define REFLECT_BINDINGS_153 REFLECT_BINDINGS_152, f152
+#define REFLECT_BINDINGS_154 REFLECT_BINDINGS_153, f153
+#define REFLECT_BINDINGS_155 REFLECT_BINDINGS_154, f154
+#define REFLECT_BINDINGS_156 REFLECT_BINDINGS_155, f155
+#define REFLECT_BINDINGS_157 REFLECT_BINDINGS_156, f156
+#define REFLECT_BINDINGS_158 REFLECT_BINDINGS_157, f157
+#define REFLECT_BINDINGS_159 REFLECT_BINDINGS_158, f158
+#define REFLECT_BINDINGS_160 REFLECT_BINDINGS_159, f159
+#define REFLECT_BINDINGS_161 REFLECT_BINDINGS_160, f160
+#define REFLECT_BINDINGS_162 REFLECT_BINDINGS_161, f161
+#define REFLECT_BINDINGS_163 REFLECT_BINDINGS_162, f162
+#define REFLECT_BINDINGS_164 REFLECT_BINDINGS_163, f163
+#define REFLECT_BINDINGS_165 REFLECT_BINDINGS_164, f164
+#define REFLECT_BINDINGS_166 REFLECT_BINDINGS_165, f165
+#define REFLECT_BINDINGS_167 REFLECT_BINDINGS_166, f166
+#define REFLECT_BINDINGS_168 REFLECT_BINDINGS_167, f167
+#define REFLECT_BINDINGS_169 REFLECT_BINDINGS_168, f168
+#define REFLECT_BINDINGS_170 REFLECT_BINDINGS_169, f169
+#define REFLECT_BINDINGS_171 REFLECT_BINDINGS_170, f170
+#define REFLECT_BINDINGS_172 REFLECT_BINDINGS_171, f171
+#define REFLECT_BINDINGS_173 REFLECT_BINDINGS_172, f172
+#define REFLECT_BINDINGS_174 REFLECT_BINDINGS_173, f173
+#define REFLECT_BINDINGS_175 REFLECT_BINDINGS_174, f174
+#define REFLECT_BINDINGS_176 REFLECT_BINDINGS_175, f175
+#define REFLECT_BINDINGS_177 REFLECT_BINDINGS_176, f176
+#define REFLECT_BINDINGS_178 REFLECT_BINDINGS_177, f177
+#define REFLECT_BINDINGS_179 REFLECT_BINDINGS_178, f178
+#define REFLECT_BINDINGS_180 REFLECT_BINDINGS_179, f179
+#define REFLECT_BINDINGS_181 REFLECT_BINDINGS_180, f180
+#define REFLECT_BINDINGS_182 REFLECT_BINDINGS_181, f181
+#define REFLECT_BINDINGS_183 REFLECT_BINDINGS_182, f182
+#define REFLECT_BINDINGS_184 REFLECT_BINDINGS_183, f183
+#define REFLECT_BINDINGS_185 REFLECT_BINDINGS_184, f184
+#define REFLECT_BINDINGS_186 REFLECT_BINDINGS_185, f185
+#define REFLECT_BINDINGS_187 REFLECT_BINDINGS_186, f186
+#define REFLECT_BINDINGS_188 REFLECT_BINDINGS_187, f187
+#define REFLECT_BINDINGS_189 REFLECT_BINDINGS_188, f188
+#define REFLECT_BINDINGS_190 REFLECT_BINDINGS_189, f189
+#define REFLECT_BINDINGS_191 REFLECT_BINDINGS_190, f190
+#define REFLECT_BINDINGS_192 REFLECT_BINDINGS_191, f191
+#define REFLECT_BINDINGS_193 REFLECT_BINDINGS_192, f192
+#define REFLECT_BINDINGS_194 REFLECT_BINDINGS_193, f193
+#define REFLECT_BINDINGS_195 REFLECT_BINDINGS_194, f194
+#define REFLECT_BINDINGS_196 REFLECT_BINDINGS_195, f195
+#define REFLECT_BINDINGS_197 REFLECT_BINDINGS_196, f196
+#define REFLECT_BINDINGS_198 REFLECT_BINDINGS_197, f197
+#define REFLECT_BINDINGS_199 REFLECT_BINDINGS_198, f198
+#define REFLECT_BINDINGS_200 REFLECT_BINDINGS_199, f199
+#define REFLECT_BINDINGS_201 REFLECT_BINDINGS_200, f200
+#define REFLECT_BINDINGS_202 REFLECT_BINDINGS_201, f201
+#define REFLECT_BINDINGS_203 REFLECT_BINDINGS_202, f202
+#define REFLECT_BINDINGS_204 REFLECT_BINDINGS_203, f203
+#define REFLECT_BINDINGS_205 REFLECT_BINDINGS_204, f204
+#define REFLECT_BINDINGS_206 REFLECT_BINDINGS_205, f205
+#define REFLECT_BINDINGS_207 REFLECT_BINDINGS_206, f206
+#define REFLECT_BINDINGS_208 REFLECT_BINDINGS_207, f207
+#define REFLECT_BINDINGS_209 REFLECT_BINDINGS_208, f208
+#define REFLECT_BINDINGS_210 REFLECT_BINDINGS_209, f209
+#define REFLECT_BINDINGS_211 REFLECT_BINDINGS_210, f210
+#define REFLECT_BINDINGS_212 REFLECT_BINDINGS_211, f211
+#define REFLECT_BINDINGS_213 REFLECT_BINDINGS_212, f212
+#define REFLECT_BINDINGS_214 REFLECT_BINDINGS_213, f213
+#define REFLECT_BINDINGS_215 REFLECT_BINDINGS_214, f214
+#define REFLECT_BINDINGS_216 REFLECT_BINDINGS_215, f215
+#define REFLECT_BINDINGS_217 REFLECT_BINDINGS_216, f216
+#define REFLECT_BINDINGS_218 REFLECT_BINDINGS_217, f217
+#define REFLECT_BINDINGS_219 REFLECT_BINDINGS_218, f218
+#define REFLECT_BINDINGS_220 REFLECT_BINDINGS_219, f219
+#define REFLECT_BINDINGS_221 REFLECT_BINDINGS_220, f220
+#define REFLECT_BINDINGS_222 REFLECT_BINDINGS_221, f221
+#define REFLECT_BINDINGS_223 REFLECT_BINDINGS_222, f222
+#define REFLECT_BINDINGS_224 REFLECT_BINDINGS_223, f223
+#define REFLECT_BINDINGS_225 REFLECT_BINDINGS_224, f224
+#define REFLECT_BINDINGS_226 REFLECT_BINDINGS_225, f225
+#define REFLECT_BINDINGS_227 REFLECT_BINDINGS_226, f226
+#define REFLECT_BINDINGS_228 REFLECT_BINDINGS_227, f227
+#define REFLECT_BINDINGS_229 REFLECT_BINDINGS_228, f228
+#define REFLECT_BINDINGS_230 REFLECT_BINDINGS_229, f229
+#define REFLECT_BINDINGS_231 REFLECT_BINDINGS_230, f230
+#define REFLECT_BINDINGS_232 REFLECT_BINDINGS_231, f231
+#define REFLECT_BINDINGS_233 REFLECT_BINDINGS_232, f232
+#define REFLECT_BINDINGS_234 REFLECT_BINDINGS_233, f233
+#define REFLECT_BINDINGS_235 REFLECT_BINDINGS_234, f234
+#define REFLECT_BINDINGS_236 REFLECT_BINDINGS_235, f235
+#define REFLECT_BINDINGS_237 REFLECT_BINDINGS_236, f236
+#define REFLECT_BINDINGS_238 REFLECT_BINDINGS_237, f237
+#define REFLECT_BINDINGS_239 REFLECT_BINDINGS_238, f238
+#define REFLECT_BINDINGS_240 REFLECT_BINDINGS_239, f239
+#define REFLECT_BINDINGS_241 REFLECT_BINDINGS_240, f240
+#define REFLECT_BINDINGS_242 REFLECT_BINDINGS_241, f241
+#define REFLECT_BINDINGS_243 REFLECT_BINDINGS_242, f242
+#define REFLECT_BINDINGS_244 REFLECT_BINDINGS_243, f243
+#define REFLECT_BINDINGS_245 REFLECT_BINDINGS_244, f244
+#define REFLECT_BINDINGS_246 REFLECT_BINDINGS_245, f245
+#define REFLECT_BINDINGS_247 REFLECT_BINDINGS_246, f246
+#define REFLECT_BINDINGS_248 REFLECT_BINDINGS_247, f247
+#define REFLECT_BINDINGS_249 REFLECT_BINDINGS_248, f248
+#define REFLECT_BINDINGS_250 REFLECT_BINDINGS_249, f249
+#define REFLECT_BINDINGS_251 REFLECT_BINDINGS_250, f250
+#define REFLECT_BINDINGS_252 REFLECT_BINDINGS_251, f251
+#define REFLECT_BINDINGS_253 REFLECT_BINDINGS_252, f252
+#define REFLECT_BINDINGS_254 REFLECT_BINDINGS_253, f253
+#define REFLECT_BINDINGS_255 REFLECT_BINDINGS_254, f254
+#define REFLECT_BINDINGS_256 REFLECT_BINDINGS_255, f255
+
+#define REFLECT_VISIT(n) \
+    else if constexpr (N == n) { \
+        auto& [REFLECT_BINDINGS_##n] = object; /* too many names: T has a C array member */ \
+        return visitor(REFLECT_BINDINGS_##n); \
+    }
+
+    // Calls visitor with references to the N fields of object, bound by a
+    // structured binding of the matching size
+    template <std::size_t N, class T, class Visitor>
+    constexpr decltype(auto) VisitRawFields(T& object, Visitor&& visitor) {
+        static_assert(N <= kMaxRawFields, "too many fields to reflect");
+        if constexpr (N == 0) {
+            return visitor();
+        }
+        REFLECT_VISIT(1) REFLECT_VISIT(2) REFLECT_VISIT(3) REFLECT_VISIT(4) REFLECT_VISIT(5) REFLECT_VISIT(6) REFLECT_VISIT(7) REFLECT_VISIT(8)
+        REFLECT_VISIT(9) REFLECT_VISIT(10) REFLECT_VISIT(11) REFLECT_VISIT(12) REFLECT_VISIT(13) REFLECT_VISIT(14) REFLECT_VISIT(15) REFLECT_VISIT(16)
+        REFLECT_VISIT(17) REFLECT_VISIT(18) REFLECT_VISIT(19) REFLECT_VISIT(20) REFLECT_VISIT(21) REFLECT_VISIT(22) REFLECT_VISIT(23) REFLECT_VISIT(24)
+        REFLECT_VISIT(25) REFLECT_VISIT(26) REFLECT_VISIT(27) REFLECT_VISIT(28) REFLECT_VISIT(29) REFLECT_VISIT(30) REFLECT_VISIT(31) REFLECT_VISIT(32)
+        REFLECT_VISIT(33) REFLECT_VISIT(34) REFLECT_VISIT(35) REFLECT_VISIT(36) REFLECT_VISIT(37) REFLECT_VISIT(38) REFLECT_VISIT(39) REFLECT_VISIT(40)
+        REFLECT_VISIT(41) REFLECT_VISIT(42) REFLECT_VISIT(43) REFLECT_VISIT(44) REFLECT_VISIT(45) REFLECT_VISIT(46) REFLECT_VISIT(47) REFLECT_VISIT(48)
+        REFLECT_VISIT(49) REFLECT_VISIT(50) REFLECT_VISIT(51) REFLECT_VISIT(52) REFLECT_VISIT(53) REFLECT_VISIT(54) REFLECT_VISIT(55) REFLECT_VISIT(56)
+        REFLECT_VISIT(57) REFLECT_VISIT(58) REFLECT_VISIT(59) REFLECT_VISIT(60) REFLECT_VISIT(61) REFLECT_VISIT(62) REFLECT_VISIT(63) REFLECT_VISIT(64)
+        REFLECT_VISIT(65) REFLECT_VISIT(66) REFLECT_VISIT(67) REFLECT_VISIT(68) REFLECT_VISIT(69) REFLECT_VISIT(70) REFLECT_VISIT(71) REFLECT_VISIT(72)
+        REFLECT_VISIT(73) REFLECT_VISIT(74) REFLECT_VISIT(75) REFLECT_VISIT(76) REFLECT_VISIT(77) REFLECT_VISIT(78) REFLECT_VISIT(79) REFLECT_VISIT(80)
+        REFLECT_VISIT(81) REFLECT_VISIT(82) REFLECT_VISIT(83) REFLECT_VISIT(84) REFLECT_VISIT(85) REFLECT_VISIT(86) REFLECT_VISIT(87) REFLECT_VISIT(88)
+        REFLECT_VISIT(89) REFLECT_VISIT(90) REFLECT_VISIT(91) REFLECT_VISIT(92) REFLECT_VISIT(93) REFLECT_VISIT(94) REFLECT_VISIT(95) REFLECT_VISIT(96)
+        REFLECT_VISIT(97) REFLECT_VISIT(98) REFLECT_VISIT(99) REFLECT_VISIT(100) REFLECT_VISIT(101) REFLECT_VISIT(102) REFLECT_VISIT(103) REFLECT_VISIT(104)
+        REFLECT_VISIT(105) REFLECT_VISIT(106) REFLECT_VISIT(107) REFLECT_VISIT(108) REFLECT_VISIT(109) REFLECT_VISIT(110) REFLECT_VISIT(111) REFLECT_VISIT(112)
+        REFLECT_VISIT(113) REFLECT_VISIT(114) REFLECT_VISIT(115) REFLECT_VISIT(116) REFLECT_VISIT(117) REFLECT_VISIT(118) REFLECT_VISIT(119) REFLECT_VISIT(120)
+        REFLECT_VISIT(121) REFLECT_VISIT(122) REFLECT_VISIT(123) REFLECT_VISIT(124) REFLECT_VISIT(125) REFLECT_VISIT(126) REFLECT_VISIT(127) REFLECT_VISIT(128)
+        REFLECT_VISIT(129) REFLECT_VISIT(130) REFLECT_VISIT(131) REFLECT_VISIT(132) REFLECT_VISIT(133) REFLECT_VISIT(134) REFLECT_VISIT(135) REFLECT_VISIT(136)
+        REFLECT_VISIT(137) REFLECT_VISIT(138) REFLECT_VISIT(139) REFLECT_VISIT(140) REFLECT_VISIT(141) REFLECT_VISIT(142) REFLECT_VISIT(143) REFLECT_VISIT(144)
+        REFLECT_VISIT(145) REFLECT_VISIT(146) REFLECT_VISIT(147) REFLECT_VISIT(148) REFLECT_VISIT(149) REFLECT_VISIT(150) REFLECT_VISIT(151) REFLECT_VISIT(152)
+        REFLECT_VISIT(153) REFLECT_VISIT(154) REFLECT_VISIT(155) REFLECT_VISIT(156) REFLECT_VISIT(157) REFLECT_VISIT(158) REFLECT_VISIT(159) REFLECT_VISIT(160)
+        REFLECT_VISIT(161) REFLECT_VISIT(162) REFLECT_VISIT(163) REFLECT_VISIT(164) REFLECT_VISIT(165) REFLECT_VISIT(166) REFLECT_VISIT(167) REFLECT_VISIT(168)
+        REFLECT_VISIT(169) REFLECT_VISIT(170) REFLECT_VISIT(171) REFLECT_VISIT(172) REFLECT_VISIT(173) REFLECT_VISIT(174) REFLECT_VISIT(175) REFLECT_VISIT(176)
+        REFLECT_VISIT(177) REFLECT_VISIT(178) REFLECT_VISIT(179) REFLECT_VISIT(180) REFLECT_VISIT(181) REFLECT_VISIT(182) REFLECT_VISIT(183) REFLECT_VISIT(184)
+        REFLECT_VISIT(185) REFLECT_VISIT(186) REFLECT_VISIT(187) REFLECT_VISIT(188) REFLECT_VISIT(189) REFLECT_VISIT(190) REFLECT_VISIT(191) REFLECT_VISIT(192)
+        REFLECT_VISIT(193) REFLECT_VISIT(194) REFLECT_VISIT(195) REFLECT_VISIT(196) REFLECT_VISIT(197) REFLECT_VISIT(198) REFLECT_VISIT(199) REFLECT_VISIT(200)
+        REFLECT_VISIT(201) REFLECT_VISIT(202) REFLECT_VISIT(203) REFLECT_VISIT(204) REFLECT_VISIT(205) REFLECT_VISIT(206) REFLECT_VISIT(207) REFLECT_VISIT(208)
+        REFLECT_VISIT(209) REFLECT_VISIT(210) REFLECT_VISIT(211) REFLECT_VISIT(212) REFLECT_VISIT(213) REFLECT_VISIT(214) REFLECT_VISIT(215) REFLECT_VISIT(216)
+        REFLECT_VISIT(217) REFLECT_VISIT(218) REFLECT_VISIT(219) REFLECT_VISIT(220) REFLECT_VISIT(221) REFLECT_VISIT(222) REFLECT_VISIT(223) REFLECT_VISIT(224)
+        REFLECT_VISIT(225) REFLECT_VISIT(226) REFLECT_VISIT(227) REFLECT_VISIT(228) REFLECT_VISIT(229) REFLECT_VISIT(230) REFLECT_VISIT(231) REFLECT_VISIT(232)
+        REFLECT_VISIT(233) REFLECT_VISIT(234) REFLECT_VISIT(235) REFLECT_VISIT(236) REFLECT_VISIT(237) REFLECT_VISIT(238) REFLECT_VISIT(239) REFLECT_VISIT(240)
+        REFLECT_VISIT(241) REFLECT_VISIT(242) REFLECT_VISIT(243) REFLECT_VISIT(244) REFLECT_VISIT(245) REFLECT_VISIT(246) REFLECT_VISIT(247) REFLECT_VISIT(248)
+        REFLECT_VISIT(249) REFLECT_VISIT(250) REFLECT_VISIT(251) REFLECT_VISIT(252) REFLECT_VISIT(253) REFLECT_VISIT(254) REFLECT_VISIT(255) REFLECT_VISIT(256)
+    }
+
+#undef REFLECT_VISIT
+#undef REFLECT_BINDINGS_1
+#undef REFLECT_BINDINGS_2
+#undef REFLECT_BINDINGS_3
+#undef REFLECT_BINDINGS_4
+#undef REFLECT_BINDINGS_5
+#undef REFLECT_BINDINGS_6
+#undef REFLECT_BINDINGS_7
+#undef REFLECT_BINDINGS_8
+#undef REFLECT_BINDINGS_9
+#undef REFLECT_BINDINGS_10
+#undef REFLECT_BINDINGS_11
+#undef REFLECT_BINDINGS_12
+#undef REFLECT_BINDINGS_13
+#undef REFLECT_BINDINGS_14
+#undef REFLECT_BINDINGS_15
+#undef REFLECT_BINDINGS_16
+#undef REFLECT_BINDINGS_17
+#undef REFLECT_BINDINGS_18
+#undef REFLECT_BINDINGS_19
+#undef REFLECT_BINDINGS_20
+#undef REFLECT_BINDINGS_21
+#undef REFLECT_BINDINGS_22
+#undef REFLECT_BINDINGS_23
+#undef REFLECT_BINDINGS_24
+#undef REFLECT_BINDINGS_25
+#undef REFLECT_BINDINGS_26
+#undef REFLECT_BINDINGS_27
+#undef REFLECT_BINDINGS_28
+#undef REFLECT_BINDINGS_29
+#undef REFLECT_BINDINGS_30
+#undef REFLECT_BINDINGS_31
+#undef REFLECT_BINDINGS_32
+#undef REFLECT_BINDINGS_33
+#undef REFLECT_BINDINGS_34
+#undef REFLECT_BINDINGS_35
+#undef REFLECT_BINDINGS_36
+#undef REFLECT_BINDINGS_37
+#undef REFLECT_BINDINGS_38
+#undef REFLECT_BINDINGS_39
+#undef REFLECT_BINDINGS_40
+#undef REFLECT_BINDINGS_41
+#undef REFLECT_BINDINGS_42
+#undef REFLECT_BINDINGS_43
+#undef REFLECT_BINDINGS_44
+#undef REFLECT_BINDINGS_45
+#undef REFLECT_BINDINGS_46
+#undef REFLECT_BINDINGS_47
+#undef REFLECT_BINDINGS_48
+#undef REFLECT_BINDINGS_49
+#undef REFLECT_BINDINGS_50
+#undef REFLECT_BINDINGS_51
+#undef REFLECT_BINDINGS_52
+#undef REFLECT_BINDINGS_53
+#undef REFLECT_BINDINGS_54
+#undef REFLECT_BINDINGS_55
+#undef REFLECT_BINDINGS_56
+#undef REFLECT_BINDINGS_57
+#undef REFLECT_BINDINGS_58
+#undef REFLECT_BINDINGS_59
+#undef REFLECT_BINDINGS_60
+#undef REFLECT_BINDINGS_61
+#undef REFLECT_BINDINGS_62
+#undef REFLECT_BINDINGS_63
+#undef REFLECT_BINDINGS_64
+#undef REFLECT_BINDINGS_65
+#undef REFLECT_BINDINGS_66
+#undef REFLECT_BINDINGS_67
+#undef REFLECT_BINDINGS_68
+#undef REFLECT_BINDINGS_69
+#undef REFLECT_BINDINGS_70
+#undef REFLECT_BINDINGS_71
+#undef REFLECT_BINDINGS_72
+#undef REFLECT_BINDINGS_73
+#undef REFLECT_BINDINGS_74
+#undef REFLECT_BINDINGS_75
+#undef REFLECT_BINDINGS_76
+#undef REFLECT_BINDINGS_77
+#undef REFLECT_BINDINGS_78
+#undef REFLECT_BINDINGS_79
+#undef REFLECT_BINDINGS_80
+#undef REFLECT_BINDINGS_81
+#undef REFLECT_BINDINGS_82
+#undef REFLECT_BINDINGS_83
+#undef REFLECT_BINDINGS_84
+#undef REFLECT_BINDINGS_85
+#undef REFLECT_BINDINGS_86
+#undef REFLECT_BINDINGS_87
+#undef REFLECT_BINDINGS_88
+#undef REFLECT_BINDINGS_89
+#undef REFLECT_BINDINGS_90
+#undef REFLECT_BINDINGS_91
+#undef REFLECT_BINDINGS_92
+#undef REFLECT_BINDINGS_93
+#undef REFLECT_BINDINGS_94
+#undef REFLECT_BINDINGS_95
+#undef REFLECT_BINDINGS_96
+#undef REFLECT_BINDINGS_97
+#undef REFLECT_BINDINGS_98
+#undef REFLECT_BINDINGS_99
+#undef REFLECT_BINDINGS_100
+#undef REFLECT_BINDINGS_101
+#undef REFLECT_BINDINGS_102
+#undef REFLECT_BINDINGS_103
+#undef REFLECT_BINDINGS_104
+#undef REFLECT_BINDINGS_105
+#undef REFLECT_BINDINGS_106
+#undef REFLECT_BINDINGS_107
+#undef REFLECT_BINDINGS_108
+#undef REFLECT_BINDINGS_109
+#undef REFLECT_BINDINGS_110
+#undef REFLECT_BINDINGS_111
+#undef REFLECT_BINDINGS_112
+#undef REFLECT_BINDINGS_113
+#undef REFLECT_BINDINGS_114
+#undef REFLECT_BINDINGS_115
+#undef REFLECT_BINDINGS_116
+#undef REFLECT_BINDINGS_117
+#undef REFLECT_BINDINGS_118
+#undef REFLECT_BINDINGS_119
+#undef REFLECT_BINDINGS_120
+#undef REFLECT_BINDINGS_121
+#undef REFLECT_BINDINGS_122
+#undef REFLECT_BINDINGS_123
+#undef REFLECT_BINDINGS_124
+#undef REFLECT_BINDINGS_125
+#undef REFLECT_BINDINGS_126
+#undef REFLECT_BINDINGS_127
+#undef REFLECT_BINDINGS_128
+#undef REFLECT_BINDINGS_129
+#undef REFLECT_BINDINGS_130
+#undef REFLECT_BINDINGS_131
+#undef REFLECT_BINDINGS_132
+#undef REFLECT_BINDINGS_133
+#undef REFLECT_BINDINGS_134
+#undef REFLECT_BINDINGS_135
+#undef REFLECT_BINDINGS_136
+#undef REFLECT_BINDINGS_137
+#undef REFLECT_BINDINGS_138
+#undef REFLECT_BINDINGS_139
+#undef REFLECT_BINDINGS_140
+#undef REFLECT_BINDINGS_141
+#undef REFLECT_BINDINGS_142
+#undef REFLECT_BINDINGS_143
+#undef REFLECT_BINDINGS_144
+#undef REFLECT_BINDINGS_145
+#undef REFLECT_BINDINGS_146
+#undef REFLECT_BINDINGS_147
+#undef REFLECT_BINDINGS_148
+#undef REFLECT_BINDINGS_149
+#undef REFLECT_BINDINGS_150
+#undef REFLECT_BINDINGS_151
+#undef REFLECT_BINDINGS_152
+#undef REFLECT_BINDINGS_153
+#undef REFLECT_BINDINGS_154
+#undef REFLECT_BINDINGS_155
+#undef REFLECT_BINDINGS_156
+#undef REFLECT_BINDINGS_157
+#undef REFLECT_BINDINGS_158
+#undef REFLECT_BINDINGS_159
+#undef REFLECT_BINDINGS_160
+#undef REFLECT_BINDINGS_161
+#undef REFLECT_BINDINGS_162
+#undef REFLECT_BINDINGS_163
+#undef REFLECT_BINDINGS_164
+#undef REFLECT_BINDINGS_165
+#undef REFLECT_BINDINGS_166
+#undef REFLECT_BINDINGS_167
+#undef REFLECT_BINDINGS_168
+#undef REFLECT_BINDINGS_169
+#undef REFLECT_BINDINGS_170
+#undef REFLECT_BINDINGS_171
+#undef REFLECT_BINDINGS_172
+#undef REFLECT_BINDINGS_173
+#undef REFLECT_BINDINGS_174
+#undef REFLECT_BINDINGS_175
+#undef REFLECT_BINDINGS_176
+#undef REFLECT_BINDINGS_177
+#undef REFLECT_BINDINGS_178
+#undef REFLECT_BINDINGS_179
+#undef REFLECT_BINDINGS_180
+#undef REFLECT_BINDINGS_181
+#undef REFLECT_BINDINGS_182
+#undef REFLECT_BINDINGS_183
+#undef REFLECT_BINDINGS_184
+#undef REFLECT_BINDINGS_185
+#undef REFLECT_BINDINGS_186
+#undef REFLECT_BINDINGS_187
+#undef REFLECT_BINDINGS_188
+#undef REFLECT_BINDINGS_189
+#undef REFLECT_BINDINGS_190
+#undef REFLECT_BINDINGS_191
+#undef REFLECT_BINDINGS_192
+#undef REFLECT_BINDINGS_193
+#undef REFLECT_BINDINGS_194
+#undef REFLECT_BINDINGS_195
+#undef REFLECT_BINDINGS_196
+#undef REFLECT_BINDINGS_197
+#undef REFLECT_BINDINGS_198
+#undef REFLECT_BINDINGS_199
+#undef REFLECT_BINDINGS_200
+#undef REFLECT_BINDINGS_201
+#undef REFLECT_BINDINGS_202
+#undef REFLECT_BINDINGS_203
+#undef REFLECT_BINDINGS_204
+#undef REFLECT_BINDINGS_205
+#undef REFLECT_BINDINGS_206
+#undef REFLECT_BINDINGS_207
+#undef REFLECT_BINDINGS_208
+#undef REFLECT_BINDINGS_209
+#undef REFLECT_BINDINGS_210
+#undef REFLECT_BINDINGS_211
+#undef REFLECT_BINDINGS_212
+#undef REFLECT_BINDINGS_213
+#undef REFLECT_BINDINGS_214
+#undef REFLECT_BINDINGS_215
+#undef REFLECT_BINDINGS_216
+#undef REFLECT_BINDINGS_217
+#undef REFLECT_BINDINGS_218
+#undef REFLECT_BINDINGS_219
+#undef REFLECT_BINDINGS_220
+#undef REFLECT_BINDINGS_221
+#undef REFLECT_BINDINGS_222
+#undef REFLECT_BINDINGS_223
+#undef REFLECT_BINDINGS_224
+#undef REFLECT_BINDINGS_225
+#undef REFLECT_BINDINGS_226
+#undef REFLECT_BINDINGS_227
+#undef REFLECT_BINDINGS_228
+#undef REFLECT_BINDINGS_229
+#undef REFLECT_BINDINGS_230
+#undef REFLECT_BINDINGS_231
+#undef REFLECT_BINDINGS_232
+#undef REFLECT_BINDINGS_233
+#undef REFLECT_BINDINGS_234
+#undef REFLECT_BINDINGS_235
+#undef REFLECT_BINDINGS_236
+#undef REFLECT_BINDINGS_237
+#undef REFLECT_BINDINGS_238
+#undef REFLECT_BINDINGS_239
+#undef REFLECT_BINDINGS_240
+#undef REFLECT_BINDINGS_241
+#undef REFLECT_BINDINGS_242
+#undef REFLECT_BINDINGS_243
+#undef REFLECT_BINDINGS_244
+#undef REFLECT_BINDINGS_245
+#undef REFLECT_BINDINGS_246
+#undef REFLECT_BINDINGS_247
+#undef REFLECT_BINDINGS_248
+#undef REFLECT_BINDINGS_249
+#undef REFLECT_BINDINGS_250
+#undef REFLECT_BINDINGS_251
+#undef REFLECT_BINDINGS_252
+#undef REFLECT_BINDINGS_253
+#undef REFLECT_BINDINGS_254
+#undef REFLECT_BINDINGS_255
+#undef REFLECT_BINDINGS_256
+
+    struct RawFieldTypes {
+        template <class... Fs>
+        RawFields<std::remove_reference_t<Fs>...> operator()(Fs&&...) const;
+    };
+
+    template <std::size_t raw, class F>
+    struct FieldRef {
+        F& field;
+    };
+
+    template <class Indices, class... Fs>
+    struct SFieldRefs;
+
+    // One base per field, so that FieldAt finds the raw-th by overload
+    // resolution instead of by recursing through a tuple
+    template <std::size_t... raw, class... Fs>
+    struct SFieldRefs<std::index_sequence<raw...>, Fs...> : FieldRef<raw, Fs>... {};
+
+    template <class... Fs>
+    using FieldRefs = SFieldRefs<std::make_index_sequence<sizeof...(Fs)>, Fs...>;
+
+    struct RefFields {
+        template <class... Fs>
+        constexpr FieldRefs<Fs...> operator()(Fs&... fields) const {
+            return {{fields}...};
+        }
+    };
+
+    template <std::size_t raw, class F>
+    constexpr F& FieldAt(const FieldRef<raw, F>& ref) {
+        return ref.field;
+    }
+
+    template <template <class...> class AnnotationTemplate, class Annotation>
+    inline constexpr bool kIsInstanceOf = false;
+
+    template <template <class...> class AnnotationTemplate, class... Args>
+    inline constexpr bool kIsInstanceOf<AnnotationTemplate, AnnotationTemplate<Args...>> = true;
+
+    template <template <class...> class AnnotationTemplate, class... Annotations>
+    struct SFindAnnotation;
+
     template <class Annotation>
-    static constexpr bool has_annotation_class = /* ... */;
+    struct SFoundAnnotation {
+        using Type = Annotation;
+    };
 
-    template <template <class...> class AnnotationTemplate>
-    using FindAnnotation = /* ... */;
-};
+    template <template <class...> class AnnotationTemplate, class Head, class... Tail>
+    struct SFindAnnotation<AnnotationTemplate, Head, Tail...>
+        : std::conditional_t<
+            kIsInstanceOf<AnnotationTemplate, Head>,
+            SFoundAnnotation<Head>,
+            SFindAnnotation<AnnotationTemplate, Tail...>
+        > {};
+
+    template <class T, class Annotations, std::size_t raw_index>
+    struct FieldDescriptor;
+
+    template <class T, class... As, std::size_t raw>
+    struct FieldDescriptor<T, Annotate<As...>, raw> {
+        using Type = T;
+        using Annotations = Annotate<As...>;
 
+        // Position among all members, Annotate ones included
+        static constexpr std::size_t raw_index = raw;
+
+        template <template <class...> class AnnotationTemplate>
+        static constexpr bool has_annotation_template = (kIsInstanceOf<AnnotationTemplate, As> || ...);
+
+        template <class Annotation>
+        static constexpr bool has_annotation_class = (std::is_same_v<Annotation, As> || ...);
+
+        template <template <class...> class AnnotationTemplate>
+        using FindAnnotation = typename SFindAnnotation<AnnotationTemplate, As...>::Type;
+    };
+
+    // Folds the Annotate<...> members into the descriptor of the next real field
+    template <class Fields, class Pending, std::size_t raw, class... Rest>
+    struct SCollectFields;
+
+    template <class... Fs, class Pending, std::size_t raw>
+    struct SCollectFields<RawFields<Fs...>, Pending, raw> {
+        using Type = RawFields<Fs...>;
+    };
+
+    template <class... Fs, class... Ps, std::size_t raw, class... As, class... Rest>
+    struct SCollectFields<RawFields<Fs...>, Annotate<Ps...>, raw, Annotate<As...>, Rest...>
+        : SCollectFields<RawFields<Fs...>, Annotate<Ps..., As...>, raw + 1, Rest...> {};
+
+    template <class... Fs, class... Ps, std::size_t raw, class... As, class... Rest>
+    struct SCollectFields<RawFields<Fs...>, Annotate<Ps...>, raw, const Annotate<As...>, Rest...>
+        : SCollectFields<RawFields<Fs...>, Annotate<Ps..., As...>, raw + 1, Rest...> {};
+
+    template <class... Fs, class Pending, std::size_t raw, class Head, class... Rest>
+    struct SCollectFields<RawFields<Fs...>, Pending, raw, Head, Rest...>
+        : SCollectFields<RawFields<Fs..., FieldDescriptor<Head, Pending, raw>>, Annotate<>, raw + 1, Rest...> {};
+
+    template <class Raw>
+    struct SFields;
+
+    template <class... Ts>
+    struct SFields<RawFields<Ts...>> {
+        using Type = typename SCollectFields<RawFields<>, Annotate<>, 0, Ts...>::Type;
+    };
+
+    template <class Fields>
+    struct SFieldList;
+
+    template <class... Fs>
+    struct SFieldList<RawFields<Fs...>> {
+        static constexpr std::size_t size = sizeof...(Fs);
+
+        template <std::size_t I>
+        using At = std::tuple_element_t<I, std::tuple<Fs...>>;
+    };
+
+} // namespace detail
+
+
+// Compile-time description of the fields of an aggregate T, in declaration
+// order, with the Annotate<...> members folded into the field after them.
+// Fields are counted by brace-initializing T, where a C array member such as
+// int a[3] takes one initializer per element, so T must not have one: the
+// count then exceeds the members and the structured binding in
+// VisitRawFields fails. Use std::array instead.
 template <class T>
 struct Describe {
-    static constexpr std::size_t num_fields = /* number of fields */
-    
+ private:
+    static_assert(std::is_aggregate_v<T>, "Describe needs an aggregate");
+
+    static constexpr std::size_t raw_fields_ = detail::CountRawFields<T>();
+
+    using RawTypes = decltype(detail::VisitRawFields<raw_fields_>(std::declval<T&>(), detail::RawFieldTypes{}));
+    using Fields = detail::SFieldList<typename detail::SFields<RawTypes>::Type>;
+
+ public:
+    static constexpr std::size_t num_fields = Fields::size;
+
+    template <std::size_t I>
+    using Field = typename Fields::template At<I>;
+
+    // The I-th field of object, Annotate members skipped
+    template <std::size_t I>
+    static constexpr auto& Get(T& object) {
+        return detail::FieldAt<Field<I>::raw_index>(detail::VisitRawFields<raw_fields_>(object, detail::RefFields{}));
+    }
+
     template <std::size_t I>
-    using Field = /* field descriptor */;
+    static constexpr const auto& Get(const T& object) {
+        return detail::FieldAt<Field<I>::raw_index>(detail::VisitRawFields<raw_fields_>(object, detail::RefFields{}));
+    }
 };
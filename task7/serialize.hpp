@@ -0,0 +1,501 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "reflect.hpp"
+#include "../task1/Span.hpp"
+
+
+// Field annotations understood by Serialize/Deserialize:
+//   Annotate<NoSerialize>  the field is not written and left untouched on read
+//   Annotate<Varint>       integers and enums as LEB128, signed ones zigzagged
+//   Annotate<BigEndian>    arithmetic and enum fields in big-endian byte order
+// Everything else is little-endian. Strings, vectors, std::string_view and
+// Span<const E> are a varint length, zero padding up to a multiple of
+// alignof(E) from the start of the buffer, and the elements; on read the
+// views point into the input buffer instead of copying, so a buffer holding
+// views must itself be aligned to the largest alignof(E) among them, as
+// anything from operator new is. bool fields must hold 0 or 1 on read.
+struct NoSerialize {};
+struct Varint {};
+struct BigEndian {};
+
+
+namespace detail {
+
+    template <class U>
+    inline constexpr bool kIsStdArray = false;
+
+    template <class E, std::size_t N>
+    inline constexpr bool kIsStdArray<std::array<E, N>> = true;
+
+    template <class U>
+    inline constexpr bool kIsView = false;
+
+    template <class C>
+    inline constexpr bool kIsView<std::basic_string_view<C>> = true;
+
+    template <class E>
+    inline constexpr bool kIsView<Span<const E>> = true;
+
+    // Whether the field descriptor carries Annotation; void for elements of arrays
+    template <class Field, class Annotation>
+    inline constexpr bool kAnnotated = Field::template has_annotation_class<Annotation>;
+
+    template <class Annotation>
+    inline constexpr bool kAnnotated<void, Annotation> = false;
+
+    template <class U>
+    concept Scalar = std::is_arithmetic_v<U> || std::is_enum_v<U>;
+
+    // std::string, std::vector and the like of trivially copyable elements
+    template <class U>
+    concept ByteContainer = !kIsView<U> && requires(U& u, std::size_t n) {
+        typename U::value_type;
+        requires std::is_trivially_copyable_v<typename U::value_type>;
+        u.resize(n);
+        { u.data() } -> std::convertible_to<const typename U::value_type*>;
+        { u.size() } -> std::convertible_to<std::size_t>;
+    };
+
+    template <class U>
+    concept Reflected = std::is_aggregate_v<U> && !std::is_array_v<U> && !kIsStdArray<U>;
+
+    template <class U>
+    inline constexpr bool kRawElements = Scalar<U> &&
+        (sizeof(U) == 1 || std::endian::native == std::endian::little);
+
+    // Whether the bytes of count elements E are valid values of E: every
+    // byte pattern is, except for bool
+    template <class E>
+    bool ValidElements(const std::byte* bytes, std::size_t count) {
+        if constexpr (std::is_same_v<std::remove_cv_t<E>, bool>) {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (static_cast<unsigned char>(bytes[i]) > 1) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    template <class U>
+    inline constexpr bool kHasBool = std::is_same_v<U, bool>;
+
+    template <class E, std::size_t N>
+    inline constexpr bool kHasBool<std::array<E, N>> = std::is_same_v<std::remove_cv_t<E>, bool>;
+
+    // Fields whose wire bytes are their memory bytes; bools are read one by
+    // one so that they can be checked
+    template <class Field>
+    constexpr bool IsPlainField() {
+        using U = std::remove_cv_t<typename Field::Type>;
+        if constexpr (Field::template has_annotation_class<NoSerialize> ||
+                      Field::template has_annotation_class<Varint> || kHasBool<U>) {
+            return false;
+        } else if constexpr (Field::template has_annotation_class<BigEndian>) {
+            return Scalar<U> && sizeof(U) == 1;
+        } else if constexpr (kIsStdArray<U>) {
+            return kRawElements<typename U::value_type>;
+        } else {
+            return kRawElements<U>;
+        }
+    }
+
+    template <class T, std::size_t I>
+    constexpr std::size_t PlainRunEnd() {
+        if constexpr (I < Describe<T>::num_fields) {
+            if constexpr (IsPlainField<typename Describe<T>::template Field<I>>()) {
+                return PlainRunEnd<T, I + 1>();
+            }
+        }
+        return I;
+    }
+
+    template <class T, std::size_t first, std::size_t... I>
+    constexpr std::size_t RunBytes(std::index_sequence<I...>) {
+        return (std::size_t{0} + ... + sizeof(typename Describe<T>::template Field<first + I>::Type));
+    }
+
+    // True when the fields from first on follow each other without padding;
+    // constant-folded by the optimizer
+    template <class T, std::size_t first, std::size_t... I>
+    bool IsContiguousRun(const T& object, std::index_sequence<I...>) {
+        const auto* base = reinterpret_cast<const std::byte*>(&Describe<T>::template Get<first>(object));
+        return ((reinterpret_cast<const std::byte*>(&Describe<T>::template Get<first + I>(object)) ==
+                 base + RunBytes<T, first>(std::make_index_sequence<I>())) && ...);
+    }
+
+    template <class U>
+    const auto* SequenceData(const U& value) {
+        if constexpr (requires { value.Data(); }) {
+            return value.Data();
+        } else {
+            return value.data();
+        }
+    }
+
+    template <class U>
+    std::size_t SequenceSize(const U& value) {
+        if constexpr (requires { value.Size(); }) {
+            return value.Size();
+        } else {
+            return value.size();
+        }
+    }
+
+    template <class U>
+    U ByteSwap(U value) {
+        std::array<std::byte, sizeof(U)> bytes;
+        std::memcpy(bytes.data(), &value, sizeof(U));
+        for (std::size_t i = 0; i < sizeof(U) / 2; ++i) {
+            std::swap(bytes[i], bytes[sizeof(U) - 1 - i]);
+        }
+        std::memcpy(&value, bytes.data(), sizeof(U));
+        return value;
+    }
+
+    template <class U>
+    U ToWire(U value, std::endian order) {
+        return order == std::endian::native ? value : ByteSwap(value);
+    }
+
+    class WireWriter {
+     public:
+        explicit WireWriter(Span<std::byte> out)
+            : start_(out.Data()), pos_(out.Data()), end_(out.Data() + out.Size()) {}
+
+        bool Put(const void* data, std::size_t size) {
+            if (static_cast<std::size_t>(end_ - pos_) < size) {
+                return false;
+            }
+            std::memcpy(pos_, data, size);
+            pos_ += size;
+            return true;
+        }
+
+        bool PutVarint(std::uint64_t value) {
+            do {
+                if (pos_ == end_) {
+                    return false;
+                }
+                auto byte = static_cast<std::uint8_t>(value & 0x7f);
+                value >>= 7;
+                *pos_++ = static_cast<std::byte>(byte | (value != 0 ? 0x80 : 0));
+            } while (value != 0);
+            return true;
+        }
+
+        // Zero bytes up to a multiple of align from the start of the buffer
+        bool PutPadding(std::size_t align) {
+            auto padding = static_cast<std::size_t>(start_ - pos_) & (align - 1);
+            if (static_cast<std::size_t>(end_ - pos_) < padding) {
+                return false;
+            }
+            std::memset(pos_, 0, padding);
+            pos_ += padding;
+            return true;
+        }
+
+        std::byte* Position() const {
+            return pos_;
+        }
+
+     private:
+        std::byte* start_;
+        std::byte* pos_;
+        std::byte* end_;
+    };
+
+    class WireReader {
+     public:
+        explicit WireReader(Span<const std::byte> in)
+            : start_(in.Data()), pos_(in.Data()), end_(in.Data() + in.Size()) {}
+
+        // Pointer to the next size bytes, nullptr if the input is shorter
+        const std::byte* Take(std::size_t size) {
+            if (static_cast<std::size_t>(end_ - pos_) < size) {
+                return nullptr;
+            }
+            return std::exchange(pos_, pos_ + size);
+        }
+
+        bool Get(void* data, std::size_t size) {
+            const std::byte* bytes = Take(size);
+            if (bytes == nullptr) {
+                return false;
+            }
+            std::memcpy(data, bytes, size);
+            return true;
+        }
+
+        bool GetVarint(std::uint64_t& value) {
+            value = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7) {
+                if (pos_ == end_) {
+                    return false;
+                }
+                auto byte = static_cast<std::uint8_t>(*pos_++);
+                value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Skips what PutPadding(align) wrote
+        bool SkipPadding(std::size_t align) {
+            return Take(static_cast<std::size_t>(start_ - pos_) & (align - 1)) != nullptr;
+        }
+
+        const std::byte* Position() const {
+            return pos_;
+        }
+
+     private:
+        const std::byte* start_;
+        const std::byte* pos_;
+        const std::byte* end_;
+    };
+
+    template <class U>
+    std::uint64_t ToVarint(U value) {
+        if constexpr (std::is_enum_v<U>) {
+            return ToVarint(static_cast<std::underlying_type_t<U>>(value));
+        } else if constexpr (std::is_signed_v<U>) {
+            auto wide = static_cast<std::int64_t>(value);
+            return (static_cast<std::uint64_t>(wide) << 1) ^ static_cast<std::uint64_t>(wide >> 63);
+        } else {
+            return static_cast<std::uint64_t>(value);
+        }
+    }
+
+    template <class U>
+    U FromVarint(std::uint64_t raw) {
+        if constexpr (std::is_enum_v<U>) {
+            return static_cast<U>(FromVarint<std::underlying_type_t<U>>(raw));
+        } else if constexpr (std::is_signed_v<U>) {
+            return static_cast<U>(static_cast<std::int64_t>((raw >> 1) ^ (~(raw & 1) + 1)));
+        } else {
+            return static_cast<U>(raw);
+        }
+    }
+
+    template <class T>
+    bool WriteObject(const T& object, WireWriter& out);
+
+    template <class T>
+    bool ReadObject(T& object, WireReader& in);
+
+    template <class U, class Field = void>
+    bool WriteValue(const U& value, WireWriter& out) {
+        if constexpr (Scalar<U>) {
+            if constexpr (kAnnotated<Field, Varint>) {
+                static_assert(!std::is_floating_point_v<U>, "Varint needs an integer or enum field");
+                return out.PutVarint(ToVarint(value));
+            } else if constexpr (kAnnotated<Field, BigEndian>) {
+                U wire = ToWire(value, std::endian::big);
+                return out.Put(&wire, sizeof(U));
+            } else {
+                U wire = ToWire(value, std::endian::little);
+                return out.Put(&wire, sizeof(U));
+            }
+        } else if constexpr (kIsStdArray<U>) {
+            if constexpr (kRawElements<typename U::value_type>) {
+                return out.Put(value.data(), sizeof(U));
+            } else {
+                for (const auto& element : value) {
+                    if (!WriteValue(element, out)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        } else if constexpr (kIsView<U> || ByteContainer<U>) {
+            using E = typename U::value_type;
+            static_assert(kRawElements<E>, "sequences need scalar elements stored little-endian");
+            std::size_t size = SequenceSize(value);
+            return out.PutVarint(size) && out.PutPadding(alignof(E)) &&
+                   out.Put(SequenceData(value), size * sizeof(E));
+        } else {
+            static_assert(Reflected<U>, "field type is not serializable");
+            return WriteObject(value, out);
+        }
+    }
+
+    template <class U, class Field = void>
+    bool ReadValue(U& value, WireReader& in) {
+        if constexpr (Scalar<U>) {
+            if constexpr (kAnnotated<Field, Varint>) {
+                std::uint64_t raw;
+                if (!in.GetVarint(raw) || (std::is_same_v<U, bool> && raw > 1)) {
+                    return false;
+                }
+                value = FromVarint<U>(raw);
+                return true;
+            } else if constexpr (std::is_same_v<U, bool>) {
+                const std::byte* byte = in.Take(1);
+                if (byte == nullptr || !ValidElements<bool>(byte, 1)) {
+                    return false;
+                }
+                value = *byte == std::byte{1};
+                return true;
+            } else {
+                constexpr auto order = kAnnotated<Field, BigEndian> ? std::endian::big : std::endian::little;
+                if (!in.Get(&value, sizeof(U))) {
+                    return false;
+                }
+                value = ToWire(value, order);
+                return true;
+            }
+        } else if constexpr (kIsStdArray<U>) {
+            if constexpr (kRawElements<typename U::value_type>) {
+                const std::byte* bytes = in.Take(sizeof(U));
+                if (bytes == nullptr || !ValidElements<typename U::value_type>(bytes, value.size())) {
+                    return false;
+                }
+                std::memcpy(value.data(), bytes, sizeof(U));
+                return true;
+            } else {
+                for (auto& element : value) {
+                    if (!ReadValue(element, in)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        } else if constexpr (kIsView<U>) {
+            using E = typename U::value_type;
+            std::uint64_t size;
+            if (!in.GetVarint(size) || size > SIZE_MAX / sizeof(E) || !in.SkipPadding(alignof(E))) {
+                return false;
+            }
+            const std::byte* bytes = in.Take(static_cast<std::size_t>(size) * sizeof(E));
+            // Views cannot point at misaligned elements, which only happens
+            // when the buffer itself is less aligned than E
+            if (bytes == nullptr || reinterpret_cast<std::uintptr_t>(bytes) % alignof(E) != 0 ||
+                !ValidElements<E>(bytes, static_cast<std::size_t>(size))) {
+                return false;
+            }
+            value = U(reinterpret_cast<const E*>(bytes), static_cast<std::size_t>(size));
+            return true;
+        } else if constexpr (ByteContainer<U>) {
+            using E = typename U::value_type;
+            std::uint64_t size;
+            if (!in.GetVarint(size) || size > SIZE_MAX / sizeof(E) || !in.SkipPadding(alignof(E))) {
+                return false;
+            }
+            const std::byte* bytes = in.Take(static_cast<std::size_t>(size) * sizeof(E));
+            if (bytes == nullptr || !ValidElements<E>(bytes, static_cast<std::size_t>(size))) {
+                return false;
+            }
+            value.resize(static_cast<std::size_t>(size));
+            std::memcpy(value.data(), bytes, static_cast<std::size_t>(size) * sizeof(E));
+            return true;
+        } else {
+            static_assert(Reflected<U>, "field type is not deserializable");
+            return ReadObject(value, in);
+        }
+    }
+
+    // Runs of plain fields without padding between them go out in one memcpy
+    template <class T, std::size_t I>
+    bool WriteFields(const T& object, WireWriter& out) {
+        using D = Describe<T>;
+        if constexpr (I == D::num_fields) {
+            return true;
+        } else if constexpr (constexpr std::size_t end = PlainRunEnd<T, I>(); end > I + 1) {
+            constexpr auto run = std::make_index_sequence<end - I>();
+            bool written;
+            if (IsContiguousRun<T, I>(object, run)) {
+                written = out.Put(&D::template Get<I>(object), RunBytes<T, I>(run));
+            } else {
+                written = [&]<std::size_t... J>(std::index_sequence<J...>) {
+                    return (WriteValue(D::template Get<I + J>(object), out) && ...);
+                }(run);
+            }
+            return written && WriteFields<T, end>(object, out);
+        } else {
+            using Field = typename D::template Field<I>;
+            if constexpr (!Field::template has_annotation_class<NoSerialize>) {
+                using U = std::remove_cv_t<typename Field::Type>;
+                if (!WriteValue<U, Field>(D::template Get<I>(object), out)) {
+                    return false;
+                }
+            }
+            return WriteFields<T, I + 1>(object, out);
+        }
+    }
+
+    template <class T, std::size_t I>
+    bool ReadFields(T& object, WireReader& in) {
+        using D = Describe<T>;
+        if constexpr (I == D::num_fields) {
+            return true;
+        } else if constexpr (constexpr std::size_t end = PlainRunEnd<T, I>(); end > I + 1) {
+            constexpr auto run = std::make_index_sequence<end - I>();
+            bool read;
+            if (IsContiguousRun<T, I>(object, run)) {
+                read = in.Get(&D::template Get<I>(object), RunBytes<T, I>(run));
+            } else {
+                read = [&]<std::size_t... J>(std::index_sequence<J...>) {
+                    return (ReadValue(D::template Get<I + J>(object), in) && ...);
+                }(run);
+            }
+            return read && ReadFields<T, end>(object, in);
+        } else {
+            using Field = typename D::template Field<I>;
+            if constexpr (!Field::template has_annotation_class<NoSerialize>) {
+                using U = std::remove_cv_t<typename Field::Type>;
+                if (!ReadValue<U, Field>(D::template Get<I>(object), in)) {
+                    return false;
+                }
+            }
+            return ReadFields<T, I + 1>(object, in);
+        }
+    }
+
+    template <class T>
+    bool WriteObject(const T& object, WireWriter& out) {
+        return WriteFields<T, 0>(object, out);
+    }
+
+    template <class T>
+    bool ReadObject(T& object, WireReader& in) {
+        return ReadFields<T, 0>(object, in);
+    }
+
+} // namespace detail
+
+
+// Writes object into out. Returns the number of bytes written, nothing if out
+// is too small
+template <class T> requires detail::Reflected<T>
+std::optional<std::size_t> Serialize(const T& object, Span<std::byte> out) {
+    detail::WireWriter writer(out);
+    if (!detail::WriteObject(object, writer)) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(writer.Position() - out.Data());
+}
+
+// Reads object from in. Returns the number of bytes consumed, nothing if in
+// is truncated or malformed. string_view and Span<const E> fields of object
+// point into in afterwards.
+template <class T> requires detail::Reflected<T>
+std::optional<std::size_t> Deserialize(T& object, Span<const std::byte> in) {
+    detail::WireReader reader(in);
+    if (!detail::ReadObject(object, reader)) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(reader.Position() - in.Data());
+}
@@ -0,0 +1,120 @@
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "../task1/BitSpan.hpp"
+
+
+// Checks BitSpan against std::vector<bool> on random offsets, sizes and
+// operations over random words, bits outside the views included
+
+constexpr std::size_t kWords = 8;
+
+std::vector<bool> Bits(const std::array<std::uint64_t, kWords>& words) {
+  std::vector<bool> bits(kWords * 64);
+  for (std::size_t i = 0; i < bits.size(); ++i) {
+    bits[i] = (words[i / 64] >> (i % 64)) & 1;
+  }
+  return bits;
+}
+
+int main() {
+  std::mt19937_64 random(17);
+  auto sparse = [&] {
+    // Mostly empty words too, so FindFirstSet and Select cross zero words
+    std::uint64_t word = random();
+    return random() % 3 == 0 ? word : random() % 2 == 0 ? 0 : word & random() & random();
+  };
+
+  for (int round = 0; round < 20000; ++round) {
+    std::array<std::uint64_t, kWords> a;
+    std::array<std::uint64_t, kWords> b;
+    for (std::size_t k = 0; k < kWords; ++k) {
+      a[k] = sparse();
+      b[k] = sparse();
+    }
+    std::size_t size = random() % (kWords * 64 / 2 + 1);
+    std::size_t a_offset = random() % (kWords * 64 - size + 1);
+    std::size_t b_offset = random() % (kWords * 64 - size + 1);
+    auto bits_a = Bits(a);
+    auto bits_b = Bits(b);
+
+    BitSpan view(a.data(), size, a_offset);
+    ConstBitSpan<> other(b.data(), size, b_offset);
+    assert(view.Size() == size);
+
+    // Queries
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+      assert(view.Test(i) == bits_a[a_offset + i]);
+      count += bits_a[a_offset + i];
+    }
+    assert(view.Count() == count);
+    std::size_t idx = random() % (size + 1);
+    std::size_t rank = 0;
+    for (std::size_t i = 0; i < idx; ++i) {
+      rank += bits_a[a_offset + i];
+    }
+    assert(view.Rank(idx) == rank);
+    std::optional<std::size_t> first;
+    for (std::size_t i = idx; i < size && !first; ++i) {
+      if (bits_a[a_offset + i]) {
+        first = i;
+      }
+    }
+    assert(view.FindFirstSet(idx) == first);
+    std::size_t k = random() % (count + 2);
+    std::optional<std::size_t> selected;
+    for (std::size_t i = 0, seen = 0; i < size && !selected; ++i) {
+      if (bits_a[a_offset + i] && seen++ == k) {
+        selected = i;
+      }
+    }
+    assert(view.Select(k) == selected);
+    std::size_t part = random() % (size + 1);
+    assert(view.First(part).Count() + view.Last(size - part).Count() == count);
+
+    // Modifications: every bit of the view changes as the oracle says, no
+    // bit outside it changes, and the other operand is left alone
+    auto expected = bits_a;
+    int op = static_cast<int>(random() % 8);
+    bool fill = random() % 2 == 0;
+    for (std::size_t i = 0; i < size; ++i) {
+      bool x = bits_a[a_offset + i];
+      bool y = bits_b[b_offset + i];
+      bool results[] = {fill, y, x && y, x || y, x != y, x && !y, !x, x && x};
+      expected[a_offset + i] = results[op];
+    }
+    switch (op) {
+      case 0: view.Fill(fill); break;
+      case 1: view.CopyFrom(other); break;
+      case 2: view.And(other); break;
+      case 3: view.Or(other); break;
+      case 4: view.Xor(other); break;
+      case 5: view.AndNot(other); break;
+      case 6:
+        for (std::size_t i = 0; i < size; ++i) {
+          view[i].Flip();
+        }
+        break;
+      case 7: view.And(view); break;
+    }
+    assert(Bits(a) == expected);
+    assert(Bits(b) == bits_b);
+  }
+
+  // Static extents and the proxy
+  {
+    std::uint64_t words[3] = {0, 0, 0};
+    BitSpan<70> bits(words, 70, 60);
+    bits[5] = true;
+    bits[69] = bits[5];
+    assert(words[0] == 0 && words[1] == 2 && words[2] == 2);
+    assert(bits.Last<1>().Count() == 1 && bits.First<5>().Count() == 0);
+    assert(*bits.FindFirstSet() == 5 && *bits.Select(1) == 69 && !bits.Select(2));
+  }
+}
@@ -0,0 +1,84 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../task7/columnar.hpp"
+
+
+enum class Side : std::uint8_t { kBuy = 1, kSell = 2 };
+enum Plain { kPlainA, kPlainB };
+
+struct Fill {
+  std::uint64_t id;
+  double price;
+  Side side;
+  bool live;
+  Annotate<Nullable> _;
+  std::optional<std::int32_t> venue;
+};
+
+static_assert(detail::kReadableColumn<Side> && detail::kReadableColumn<std::byte>);
+static_assert(detail::kReadableColumn<bool> && detail::kReadableColumn<float>);
+static_assert(!detail::kReadableColumn<Plain> && !detail::kReadableColumn<const char*>);
+
+// The block copied into 8-byte aligned memory, as a mapped file would be
+std::vector<std::uint64_t> Store(const ColumnarBatch<Fill>& batch) {
+  std::ostringstream out;
+  batch.WriteTo(out);
+  std::string bytes = out.str();
+  std::vector<std::uint64_t> words(bytes.size() / sizeof(std::uint64_t));
+  std::memcpy(words.data(), bytes.data(), bytes.size());
+  return words;
+}
+
+Span<const std::byte> Bytes(const std::vector<std::uint64_t>& words) {
+  return {reinterpret_cast<const std::byte*>(words.data()), words.size() * sizeof(std::uint64_t)};
+}
+
+int main() {
+  ColumnarBatch<Fill> batch;
+  for (std::uint64_t i = 0; i < 100; ++i) {
+    batch.Append(Fill{i, 1.5 * static_cast<double>(i), i % 3 ? Side::kBuy : Side::kSell, i % 2 == 0, {},
+                      i % 5 ? std::optional<std::int32_t>(static_cast<std::int32_t>(i)) : std::nullopt});
+  }
+
+  // Columns read back as written, nulls included
+  auto words = Store(batch);
+  {
+    auto block = ColumnarBlock<Fill>::Parse(Bytes(words));
+    assert(block && block->Size() == 100 && block->BlockBytes() == words.size() * sizeof(std::uint64_t));
+    for (std::size_t i = 0; i < 100; ++i) {
+      assert(block->Column<0>()[i] == i && block->Column<1>()[i] == 1.5 * static_cast<double>(i));
+      assert(block->Column<2>()[i] == batch.Column<2>()[i] && block->Column<3>()[i] == (i % 2 == 0));
+      assert(block->IsNull<4>(i) == (i % 5 == 0));
+      assert(block->IsNull<4>(i) || block->Column<4>()[i] == static_cast<std::int32_t>(i));
+    }
+  }
+
+  // A bool column holding anything but 0 or 1 is rejected
+  {
+    auto block = ColumnarBlock<Fill>::Parse(Bytes(words));
+    std::size_t live = static_cast<std::size_t>(
+        reinterpret_cast<const std::byte*>(block->Column<3>().Data()) - Bytes(words).Data());
+    auto corrupt = words;
+    reinterpret_cast<unsigned char*>(corrupt.data())[live + 99] = 2;
+    assert(!ColumnarBlock<Fill>::Parse(Bytes(corrupt)));
+    reinterpret_cast<unsigned char*>(corrupt.data())[live + 99] = 1;
+    assert(ColumnarBlock<Fill>::Parse(Bytes(corrupt)));
+  }
+
+  // Truncated, misaligned or foreign blocks are rejected
+  {
+    auto bytes = Bytes(words);
+    assert(!ColumnarBlock<Fill>::Parse({bytes.Data(), bytes.Size() - 64}));
+    assert(!ColumnarBlock<Fill>::Parse({bytes.Data() + 1, bytes.Size() - 1}));
+    auto corrupt = words;
+    reinterpret_cast<char*>(corrupt.data())[0] = 'X';
+    assert(!ColumnarBlock<Fill>::Parse(Bytes(corrupt)));
+  }
+}
@@ -0,0 +1,95 @@
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "../task2/Expr.hpp"
+
+
+// Small integers, so every double result is exact
+std::vector<double> Values(std::size_t size, int seed) {
+  std::vector<double> values(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    values[i] = static_cast<double>((static_cast<int>(i) * 7 + seed) % 11 - 5);
+  }
+  return values;
+}
+
+int main() {
+  // Three to six operands, scalars on either side, against a plain loop,
+  // at sizes around the vector width and its multiples
+  for (std::size_t size : {0, 1, 3, 7, 8, 9, 31, 64, 65, 1000}) {
+    auto a = Values(size, 1);
+    auto b = Values(size, 2);
+    auto c = Values(size, 3);
+    auto d = Values(size, 4);
+    auto e = Values(size, 5);
+    auto f = Values(size, 6);
+    Span<const double> sa(a.data(), size), sb(b.data(), size), sc(c.data(), size), sd(d.data(), size),
+        se(e.data(), size), sf(f.data(), size);
+    std::vector<double> out(size, 99);
+    Span<double> so(out.data(), size);
+
+    so = sa * sb + sc;
+    for (std::size_t i = 0; i < size; ++i) {
+      assert(out[i] == a[i] * b[i] + c[i]);
+    }
+    so = sa * sb + sc * sd - se / 2.0;
+    for (std::size_t i = 0; i < size; ++i) {
+      assert(out[i] == a[i] * b[i] + c[i] * d[i] - e[i] / 2.0);
+    }
+    so = 3.0 - (sa + sb) * (sc - sd) + -se * sf;
+    for (std::size_t i = 0; i < size; ++i) {
+      assert(out[i] == 3.0 - (a[i] + b[i]) * (c[i] - d[i]) + -e[i] * f[i]);
+    }
+
+    // The destination may be an operand
+    auto before = out;
+    so = so * 2.0 + sa;
+    for (std::size_t i = 0; i < size; ++i) {
+      assert(out[i] == before[i] * 2.0 + a[i]);
+    }
+
+    so = Map([](double x, double y, double z) { return x > y ? z : -z; }, sa, sb, 4.0);
+    for (std::size_t i = 0; i < size; ++i) {
+      assert(out[i] == (a[i] > b[i] ? 4.0 : -4.0));
+    }
+  }
+
+  // Strided Slices, as operands and as the destination: only the viewed
+  // elements change
+  {
+    auto a = Values(40, 1);
+    auto b = Values(20, 2);
+    std::vector<double> out(60, 99);
+    Slice<const double> whole_a(a);
+    Slice<double> whole_out(out);
+    auto every_other = whole_a.Skip(2);
+    auto every_third = whole_out.Skip(3);
+    Slice<const double> sb(b);
+    every_third = every_other * sb + 1.0;
+    for (std::size_t i = 0; i < 60; ++i) {
+      assert(out[i] == (i % 3 == 0 ? a[i / 3 * 2] * b[i / 3] + 1.0 : 99));
+    }
+    auto static_stride = whole_a.Skip<2>();
+    every_third = static_stride - sb;
+    for (std::size_t i = 0; i < 60; i += 3) {
+      assert(out[i] == a[i / 3 * 2] - b[i / 3]);
+    }
+  }
+
+  // Static extents take the constant-bound loop; Spans and Slices mix
+  {
+    std::array<int, 8> a{1, 2, 3, 4, 5, 6, 7, 8};
+    std::array<int, 8> b{8, 7, 6, 5, 4, 3, 2, 1};
+    std::array<int, 8> out{};
+    Span<const int, 8> sa(a.data(), 8);
+    Slice<const int> sb(b);
+    Span<int, 8> so(out.data(), 8);
+    static_assert(decltype(sa * sb)::extent == 8);
+    so = sa * sb - sa;
+    for (std::size_t i = 0; i < 8; ++i) {
+      assert(out[i] == a[i] * b[i] - a[i]);
+    }
+  }
+}
@@ -0,0 +1,26 @@
+#include <cassert>
+#include <string>
+#include <string_view>
+
+#include "../task4/Format.hpp"
+
+
+int main() {
+  // Always fits: the unchecked overload
+  char wide[32];
+  std::size_t size = Format<"v={} h={:x}"_cstr>(Span<char, 32>(wide), 123456, 255u);
+  assert(std::string_view(wide, size) == "v=123456 h=ff");
+
+  // Small static buffers fall back to the checked overload
+  char small[4];
+  assert(!Format<"v={}"_cstr>(Span<char, 4>(small), 123456));
+  auto fits = Format<"v={}"_cstr>(Span<char, 4>(small), 12);
+  assert(fits == 4 && std::string_view(small, 4) == "v=12");
+
+  // So do formats without a bound
+  std::string name = "abc";
+  auto unbounded = Format<"{}:{:.1f}"_cstr>(Span<char, 32>(wide), name, 2.25);
+  assert(unbounded && std::string_view(wide, *unbounded) == "abc:2.2");
+  char tiny[2];
+  assert(!Format<"{}"_cstr>(Span<char, 2>(tiny), name));
+}
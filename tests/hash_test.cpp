@@ -0,0 +1,27 @@
+#include <cassert>
+#include <functional>
+#include <string>
+#include <unordered_set>
+
+#include "../task7/hash.hpp"
+
+
+struct Keyed {
+  std::string name;
+  int id;
+  // Neither hashable nor comparable
+  Annotate<NoHash> _;
+  std::function<int()> cache;
+};
+
+int main() {
+  Keyed a{"a", 1, {}, [] { return 1; }};
+  Keyed b{"a", 1, {}, [] { return 2; }};
+  Keyed c{"c", 1, {}, [] { return 1; }};
+  assert(ReflectEqual<Keyed>{}(a, b));
+  assert(ReflectHash<Keyed>{}(a) == ReflectHash<Keyed>{}(b));
+  assert(!ReflectEqual<Keyed>{}(a, c));
+
+  std::unordered_set<Keyed, ReflectHash<Keyed>, ReflectEqual<Keyed>> set{a, b, c};
+  assert(set.size() == 2);
+}
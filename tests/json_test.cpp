@@ -0,0 +1,118 @@
+#include <array>
+#include <cassert>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../task7/json.hpp"
+
+
+struct Level {
+  Annotate<JsonName<"px"_cstr>> _;
+  double price;
+  Annotate<JsonName<"qty"_cstr>> __;
+  long quantity;
+};
+
+enum class Side : int { kBuy = 1, kSell = 2 };
+
+struct Quote {
+  Annotate<JsonName<"sym"_cstr>> _;
+  std::string symbol;
+  Annotate<JsonName<"venue"_cstr>> __;
+  std::string_view venue;
+  Annotate<JsonName<"side"_cstr>> ___;
+  Side side;
+  Annotate<JsonName<"live"_cstr>> ____;
+  bool live;
+  Annotate<JsonName<"best"_cstr>> _____;
+  Level best;
+  Annotate<JsonName<"bids"_cstr>> ______;
+  std::vector<Level> bids;
+  Annotate<JsonName<"flags"_cstr>> _______;
+  std::array<int, 2> flags;
+  Annotate<JsonName<"note"_cstr>> ________;
+  std::optional<std::string> note;
+  // Not named, so never read
+  int unnamed;
+};
+
+std::optional<std::size_t> Parse(Quote& quote, std::string_view json) {
+  return ParseJson(quote, json);
+}
+
+int main() {
+  // Every field type, keys in any order, trailing text not consumed
+  {
+    std::string_view json =
+        R"({ "bids": [{"px": 99.5, "qty": 3}, {"qty": 1, "px": 99}], "sym": "ABC", "venue": "X1",)"
+        R"( "side": 2, "live": true, "best": {"px": 100.25, "qty": 7}, "flags": [4, -5],)"
+        R"( "note": null, "unnamed": 9 } tail)";
+    Quote quote{};
+    quote.unnamed = 1;
+    quote.note = "old";
+    auto consumed = Parse(quote, json);
+    assert(consumed && json.substr(*consumed) == " tail");
+    assert(quote.symbol == "ABC" && quote.venue == "X1" && quote.side == Side::kSell && quote.live);
+    assert(quote.best.price == 100.25 && quote.best.quantity == 7);
+    assert(quote.bids.size() == 2 && quote.bids[1].price == 99 && quote.bids[1].quantity == 1);
+    assert(quote.flags[0] == 4 && quote.flags[1] == -5);
+    assert(!quote.note && quote.unnamed == 1);
+  }
+
+  // Escapes, a \u escape and a surrogate pair decode to UTF-8, including in keys
+  {
+    Quote quote{};
+    assert(Parse(quote, R"({"sym": "a\"b\\c\/d\n\t\u00e9\ud83d\ude00"})"));
+    assert(quote.symbol == "a\"b\\c/d\n\t\xc3\xa9\xf0\x9f\x98\x80");
+    assert(Parse(quote, R"({"s\u0079m": "key"})") && quote.symbol == "key");
+    assert(!Parse(quote, R"({"sym": "\ud83d"})"));
+    assert(!Parse(quote, R"({"sym": "\ud83dA"})"));
+    assert(!Parse(quote, R"({"sym": "\u12"})"));
+    assert(!Parse(quote, R"({"sym": "\x"})"));
+  }
+
+  // string_view fields point into the input, so they cannot take escapes
+  {
+    Quote quote{};
+    std::string_view json = R"({"venue": "plain"})";
+    assert(Parse(quote, json));
+    assert(quote.venue.data() == json.data() + 11);
+    assert(!Parse(quote, R"({"venue": "a\nb"})"));
+  }
+
+  // Unknown keys are skipped whole, brackets and strings with brackets included
+  {
+    Quote quote{};
+    assert(Parse(quote, R"({"meta": {"a": [1, {"b": "}]\"{"}], "c": {}}, "x": [[], [[]]], "sym": "S"})"));
+    assert(quote.symbol == "S");
+    assert(!Parse(quote, R"({"meta": {"a": [1, 2}, "sym": "S")"));
+  }
+
+  // Malformed and truncated input
+  {
+    std::string_view full = R"({"sym": "ABC", "best": {"px": 1.5, "qty": 2}, "flags": [1, 2]})";
+    for (std::size_t size = 0; size < full.size(); ++size) {
+      Quote quote{};
+      assert(!Parse(quote, full.substr(0, size)));
+    }
+    for (std::string_view bad : {
+             R"({"sym" "ABC"})", R"({"sym": "ABC",})", R"({"sym": "ABC" "side": 1})", R"([1, 2])",
+             R"({"flags": [1]})", R"({"flags": [1, 2, 3]})", R"({"live": tru})", R"({"live": 1})",
+             R"({"best": {"px": nan}})", R"({"best": {"px": inf}})", R"({"best": {"px": 01}})",
+             R"({"best": {"px": 1.}})", R"({"best": {"qty": 1.5}})", R"({"best": {"qty": 99999999999999999999}})",
+             R"({"sym": 5})"}) {
+      Quote quote{};
+      assert(!Parse(quote, bad));
+    }
+  }
+
+  // A bad value leaves a bool as it was
+  {
+    Quote quote{};
+    quote.live = true;
+    assert(!Parse(quote, R"({"live": fals})"));
+    assert(quote.live);
+  }
+}
@@ -0,0 +1,80 @@
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "../task4/Regex.hpp"
+
+
+// Leftmost-longest by trying every substring
+template
+  < FixedString<256> pattern
+  >
+std::optional<std::string_view> SearchAllSubstrings(std::string_view text) {
+  for (std::size_t begin = 0; begin <= text.size(); ++begin) {
+    for (std::size_t end = text.size() + 1; end-- > begin;) {
+      if (Match<pattern>(text.substr(begin, end - begin))) {
+        return text.substr(begin, end - begin);
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+template
+  < FixedString<256> pattern
+  >
+void CheckRandom(std::string_view alphabet) {
+  std::mt19937 random(7);
+  for (int i = 0; i < 5000; ++i) {
+    std::string text(random() % 14, ' ');
+    for (auto& c : text) {
+      c = alphabet[random() % alphabet.size()];
+    }
+    auto found = Search<pattern>(text);
+    auto expected = SearchAllSubstrings<pattern>(text);
+    assert(found.has_value() == expected.has_value());
+    assert(!found || (found->data() == expected->data() && found->size() == expected->size()));
+  }
+}
+
+int main() {
+  static_assert(Match<"[a-z]+=\\d+"_cstr>("retries=3"));
+  static_assert(!Match<"[a-z]+=\\d+"_cstr>("retries="));
+  static_assert(*Search<"b+"_cstr>("aabbbc") == "bbb");
+  static_assert(!Search<"ERROR|WARN"_cstr>("INFO ok"));
+
+  // The leftmost match wins over an earlier-ending one
+  assert(*Search<"xaby|ab"_cstr>("zxaby") == "xaby");
+  // A match that started before a run of repeats is not cut short
+  assert(*Search<"a*b"_cstr>("xaaab") == "aaab");
+  // Patterns matching the empty string match at 0
+  assert(Search<"a*"_cstr>("baa")->empty());
+  assert(*Search<"a*"_cstr>("aab") == "aa");
+
+  CheckRandom<"a+b"_cstr>("ab");
+  CheckRandom<"xaby|ab"_cstr>("xaby");
+  CheckRandom<"(ab)*c|b"_cstr>("abc");
+  CheckRandom<"a|ab|abc"_cstr>("abc");
+  CheckRandom<"[a-c]{2,3}d?"_cstr>("abcd");
+  CheckRandom<"(a|b)*abb"_cstr>("ab");
+  CheckRandom<"ERROR|WARN"_cstr>("ERWANO");
+  CheckRandom<"\\d{2}:\\d{2}"_cstr>("1:2");
+
+  // A failing search reads the text a bounded number of times: 64 times
+  // the text may take at most about 64 times as long, not 4096 times
+  auto failing = [](std::size_t size) {
+    std::string text(size, 'a');
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 8; ++i) {
+      assert(!Search<"a+b"_cstr>(text));
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+  double small = failing(1 << 14);
+  double large = failing(1 << 20);
+  assert(large < small * 64 * 8);
+}
@@ -0,0 +1,59 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../task7/serialize.hpp"
+
+
+struct Record {
+  std::string name;
+  Span<const std::uint32_t> values;
+  std::vector<std::uint64_t> wide;
+  bool flag;
+};
+
+struct Flags {
+  bool first;
+  std::array<bool, 3> rest;
+};
+
+int main() {
+  const std::uint32_t values[] = {1, 0xdeadbeef, 3};
+  // Odd-length strings put the views at every offset modulo their alignment
+  for (std::size_t length = 0; length < 5; ++length) {
+    Record record{std::string(length, 'x'), Span<const std::uint32_t>(values, 3), {7, 8}, length % 2 == 1};
+    alignas(8) std::byte buffer[128];
+    auto written = Serialize(record, Span<std::byte>(buffer, sizeof(buffer)));
+    assert(written);
+
+    Record copy{};
+    auto read = Deserialize(copy, Span<const std::byte>(buffer, *written));
+    assert(read == written);
+    assert(copy.name == record.name);
+    assert(copy.values.Size() == 3);
+    for (std::size_t i = 0; i < 3; ++i) {
+      assert(copy.values[i] == values[i]);
+    }
+    assert(copy.wide == record.wide);
+    assert(copy.flag == record.flag);
+
+    // Too small a buffer for the padding fails instead of overrunning
+    assert(!Serialize(record, Span<std::byte>(buffer, *written - 1)));
+  }
+
+  Flags flags{true, {false, true, false}};
+  std::byte buffer[4];
+  assert(Serialize(flags, Span<std::byte>(buffer, 4)) == 4);
+  Flags copy{};
+  assert(Deserialize(copy, Span<const std::byte>(buffer, 4)) == 4);
+  assert(copy.first && !copy.rest[0] && copy.rest[1] && !copy.rest[2]);
+
+  // A bool is 0 or 1, nothing else
+  buffer[0] = std::byte{2};
+  assert(!Deserialize(copy, Span<const std::byte>(buffer, 4)));
+  buffer[0] = std::byte{1};
+  buffer[2] = std::byte{0xff};
+  assert(!Deserialize(copy, Span<const std::byte>(buffer, 4)));
+}
@@ -0,0 +1,60 @@
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "../task5/SpyProfiler.hpp"
+
+
+struct Counter {
+  int value = 0;
+
+  void Add(int amount) {
+    value += amount;
+  }
+};
+
+int main() {
+  // Trace() records one event per expression, keyed by call site and member
+  {
+    SpyProfiler::Reset();
+    Spy<Counter> spy;
+    for (int i = 0; i < 3; ++i) {
+      spy.Trace("Add")->Add(1);
+    }
+    spy.Trace()->Add(1);
+    assert((*spy).value == 4);
+
+    std::ostringstream trace;
+    SpyProfiler::Flush(trace);
+    assert(trace.str().find("spy_profiler_test.cpp") != std::string::npos);
+    auto stats = SpyProfiler::Statistics();
+    assert(stats.size() == 2);
+    std::uint64_t calls = 0;
+    for (const auto& [site, site_stats] : stats) {
+      assert(site.spy == &spy);
+      calls += site_stats.calls;
+      assert(site.member ? site_stats.calls == 3 : site_stats.calls == 1);
+    }
+    assert(calls == 4 && SpyProfiler::Dropped() == 0);
+  }
+
+  // Sites compare by the text of file and member, not by their addresses
+  {
+    char file[] = "a.cpp";
+    char same_file[] = "a.cpp";
+    char member[] = "Add";
+    char same_member[] = "Add";
+    SpySite site{nullptr, file, 7, member};
+    assert((site == SpySite{nullptr, same_file, 7, same_member}));
+    assert((site != SpySite{nullptr, same_file, 7, nullptr}));
+    assert((SpySite{nullptr, file, 7, nullptr} < site));
+    assert((site < SpySite{nullptr, "b.cpp", 1, nullptr}));
+
+    std::map<SpySite, int> sites;
+    ++sites[site];
+    ++sites[SpySite{nullptr, same_file, 7, same_member}];
+    assert(sites.size() == 1 && sites.begin()->second == 2);
+  }
+}
@@ -0,0 +1,79 @@
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "../task5/Spy.hpp"
+
+
+struct Counter {
+  int value = 0;
+
+  int Get() const {
+    return value;
+  }
+
+  void Add(int amount) {
+    value += amount;
+  }
+};
+
+int main() {
+  // One report per full expression, with the calls made in it
+  {
+    Spy<Counter> spy;
+    std::vector<unsigned int> reports;
+    spy.setLogger([&reports](unsigned int calls) {
+      reports.push_back(calls);
+    });
+    spy->Add(1);
+    int sum = spy->Get() + spy->Get() + spy->Get();
+    assert(sum == 3);
+    assert((reports == std::vector<unsigned int>{1, 3}));
+  }
+
+  // Concurrent Spies report every call exactly once, whether the threads
+  // join a live expression or start a new one
+  {
+    constexpr std::size_t kThreads = 4;
+    constexpr std::size_t kExpressions = 20000;
+    Spy<Counter, Concurrent> spy;
+    std::atomic<unsigned long long> logged{0};
+    spy.setLogger([&logged](unsigned int calls) {
+      logged.fetch_add(calls, std::memory_order_relaxed);
+    });
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&spy] {
+        int sum = 0;
+        for (std::size_t i = 0; i < kExpressions; ++i) {
+          sum += i % 2 == 0 ? spy->Get() : spy->Get() + spy->Get();
+        }
+        assert(sum == 0);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    assert(logged.load() == kThreads * kExpressions * 3 / 2);
+  }
+
+  // Sampling decides once per expression: with every other expression
+  // sampled on one thread, half of them are reported, each in full
+  {
+    Spy<Counter, Concurrent, SampleEveryNth<2>> spy;
+    std::vector<unsigned int> reports;
+    spy.setLogger([&reports](unsigned int calls) {
+      reports.push_back(calls);
+    });
+    for (int i = 0; i < 10; ++i) {
+      int sum = spy->Get() + spy->Get();
+      assert(sum == 0);
+    }
+    assert(reports.size() == 5);
+    for (unsigned int calls : reports) {
+      assert(calls == 2);
+    }
+  }
+}
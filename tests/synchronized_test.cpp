@@ -0,0 +1,133 @@
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "../task5/Synchronized.hpp"
+
+
+// Every published value has low + high == 0 and a version that only grows
+struct Table {
+  static inline std::atomic<int> live{0};
+
+  long version = 0;
+  long low = 0;
+  long high = 0;
+  std::vector<long> routes;
+
+  Table() {
+    live.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Table(const Table& other) : version(other.version), low(other.low), high(other.high), routes(other.routes) {
+    live.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Table& operator=(const Table&) = default;
+
+  ~Table() {
+    live.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  bool Consistent() const {
+    return low + high == 0 && routes.size() == static_cast<std::size_t>(version % 8);
+  }
+};
+
+Table Next(const Table& table) {
+  Table next = table;
+  ++next.version;
+  next.low = -next.version;
+  next.high = next.version;
+  next.routes.assign(static_cast<std::size_t>(next.version % 8), next.version);
+  return next;
+}
+
+int main() {
+  // Store, Update, Write and Load from one thread
+  {
+    Synchronized<Table> sync;
+    assert(sync->version == 0 && sync.Load().Consistent());
+    sync.Store(Next(sync.Load()));
+    assert(sync->version == 1);
+    sync.Update([](Table& table) {
+      table = Next(table);
+    });
+    assert(sync->version == 2 && sync->Consistent());
+    sync.Write()->routes.push_back(7);
+    assert(sync->routes.back() == 7 && sync.Load().routes.size() == 3);
+  }
+  assert(Table::live.load() == 0);
+
+  // A snapshot taken with Read() keeps the value it saw while another
+  // thread publishes, and the writer frees that value once it is released
+  {
+    Synchronized<Table> sync;
+    std::thread writer;
+    {
+      auto before = sync.Read();
+      writer = std::thread([&] {
+        sync.Store(Next(sync.Load()));
+      });
+      while (sync->version == 0) {
+        std::this_thread::yield();
+      }
+      assert(before->version == 0 && before->Consistent());
+    }
+    writer.join();
+    assert(Table::live.load() == 1);
+  }
+  assert(Table::live.load() == 0);
+
+  // Readers race a writer that cycles through Store, Update and Write: each
+  // read sees one whole published value, and versions never go back
+  {
+    constexpr long kWrites = 90;
+    constexpr std::size_t kReaders = 4;
+    Synchronized<Table> sync;
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> started{0};
+    std::vector<std::thread> readers;
+    for (std::size_t r = 0; r < kReaders; ++r) {
+      readers.emplace_back([&] {
+        started.fetch_add(1, std::memory_order_relaxed);
+        long seen = 0;
+        while (!done.load(std::memory_order_acquire)) {
+          assert(sync->Consistent());
+          auto snapshot = sync.Read();
+          assert(snapshot->Consistent() && snapshot->version >= seen);
+          seen = snapshot->version;
+          Table copy = sync.Load();
+          assert(copy.Consistent() && copy.version >= seen);
+          seen = copy.version;
+        }
+      });
+    }
+    while (started.load(std::memory_order_relaxed) != kReaders) {
+      std::this_thread::yield();
+    }
+    for (long i = 0; i < kWrites; ++i) {
+      // Lets the readers run between writes on a single core
+      std::this_thread::yield();
+      if (i % 3 == 0) {
+        sync.Store(Next(sync.Load()));
+      } else if (i % 3 == 1) {
+        sync.Update([](Table& table) {
+          table = Next(table);
+        });
+      } else {
+        auto writer = sync.Write();
+        *writer = Next(*writer);
+      }
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) {
+      reader.join();
+    }
+    assert(sync.Load().version == kWrites);
+    // Only the current value is left: every replaced one was freed
+    assert(Table::live.load() == 1);
+  }
+  assert(Table::live.load() == 0);
+}
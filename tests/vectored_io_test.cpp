@@ -0,0 +1,153 @@
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../task1/VectoredIO.hpp"
+
+
+int main() {
+  int fds[2];
+  assert(::pipe(fds) == 0);
+  assert(::fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0);
+
+  // More than a pipe holds, in more fragments than one batch
+  std::vector<std::byte> data(1 << 20);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<std::byte>(i * 7);
+  }
+  std::vector<Span<const std::byte>> fragments;
+  for (std::size_t i = 0; i < data.size(); i += 4099) {
+    fragments.emplace_back(data.data() + i, std::min<std::size_t>(4099, data.size() - i));
+  }
+  Span<const Span<const std::byte>> all(fragments.data(), fragments.size());
+
+  // The full pipe stops the write with the bytes written so far
+  IoResult written = WriteAll(fds[1], all);
+  assert(written.error == EAGAIN);
+  assert(written.done > 0 && written.done < data.size());
+
+  // Draining and resuming from done writes the rest, in order
+  std::vector<std::byte> received(data.size());
+  std::size_t read = 0;
+  while (written.error == EAGAIN) {
+    Span<std::byte> rest(received.data() + read, received.size() - read);
+    ssize_t got = ::read(fds[0], rest.Data(), rest.Size());
+    assert(got > 0);
+    read += static_cast<std::size_t>(got);
+    written = WriteAll(fds[1], all, written.done);
+  }
+  assert(written.error == 0 && written.done == data.size());
+  ::close(fds[1]);
+
+  Span<std::byte> tail(received.data() + read, received.size() - read);
+  IoResult rest = ReadAll(fds[0], Span<const Span<std::byte>>(&tail, 1));
+  assert(rest.error == 0 && read + rest.done == data.size());
+  assert(received == data);
+
+  // A closed descriptor reports its errno and nothing done
+  IoResult failed = ReadAll(fds[1], Span<const Span<std::byte>>(&tail, 1));
+  assert(failed.error == EBADF && failed.done == 0);
+  ::close(fds[0]);
+
+  // The same through io_uring, where the kernel allows it
+  IoUring ring(4);
+  if (ring.Error() != 0) {
+    std::printf("io_uring unavailable (errno %d), skipped\n", ring.Error());
+    return 0;
+  }
+
+  // Through a file, with more entries than the ring holds and fragments
+  // both inside and outside registered buffers
+  {
+    std::FILE* file = std::tmpfile();
+    assert(file != nullptr);
+    int fd = ::fileno(file);
+    std::vector<std::byte> registered(data.begin(), data.begin() + 3 * 4099);
+    Span<std::byte> buffer(registered.data(), registered.size());
+    assert(ring.RegisterBuffers(Span<const Span<std::byte>>(&buffer, 1)) == 0);
+    std::vector<Span<const std::byte>> mixed = fragments;
+    mixed[0] = Span<const std::byte>(registered.data(), 4099);
+    mixed[2] = Span<const std::byte>(registered.data() + 2 * 4099, 4099);
+    mixed[100] = Span<const std::byte>(registered.data() + 4099, 0);
+    mixed[101] = Span<const std::byte>(registered.data() + 4099, 4099);
+    mixed[102] = Span<const std::byte>(registered.data() + 2 * 4099, 4099);
+    std::vector<std::byte> expected;
+    for (const auto& fragment : mixed) {
+      expected.insert(expected.end(), fragment.Data(), fragment.Data() + fragment.Size());
+    }
+    IoResult file_written = ring.WriteAll(fd, Span<const Span<const std::byte>>(mixed.data(), mixed.size()));
+    assert(file_written.error == 0 && file_written.done == expected.size());
+
+    assert(::lseek(fd, 0, SEEK_SET) == 0);
+    std::vector<std::byte> back(expected.size() + 10);
+    std::vector<Span<std::byte>> parts;
+    parts.emplace_back(registered.data(), 4099);
+    for (std::size_t i = 4099; i < back.size(); i += 1000) {
+      parts.emplace_back(back.data() + i, std::min<std::size_t>(1000, back.size() - i));
+    }
+    IoResult file_read = ring.ReadAll(fd, Span<const Span<std::byte>>(parts.data(), parts.size()));
+    assert(file_read.error == 0 && file_read.done == expected.size());
+    std::copy(registered.begin(), registered.begin() + 4099, back.begin());
+    back.resize(expected.size());
+    assert(back == expected);
+
+    // Resuming skip bytes in writes only the rest
+    assert(::lseek(fd, 0, SEEK_SET) == 0);
+    IoResult resumed = ring.WriteAll(fd, Span<const Span<const std::byte>>(mixed.data(), mixed.size()), 5000);
+    assert(resumed.error == 0 && resumed.done == expected.size());
+    std::vector<std::byte> shifted(expected.size() - 5000);
+    assert(::pread(fd, shifted.data(), shifted.size(), 0) == static_cast<ssize_t>(shifted.size()));
+    assert(std::equal(shifted.begin(), shifted.end(), expected.begin() + 5000));
+    std::fclose(file);
+  }
+
+  // Through a pipe a reader drains as it goes: the ring waits for room
+  // where writev stopped with EAGAIN, and reads stop at the end of input
+  {
+    assert(::pipe(fds) == 0);
+    assert(::fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0);
+    std::vector<std::byte> piped(data.size());
+    std::thread reader([&] {
+      IoUring reader_ring;
+      Span<std::byte> whole(piped.data(), piped.size());
+      IoResult got = reader_ring.ReadAll(fds[0], Span<const Span<std::byte>>(&whole, 1));
+      assert(got.error == 0 && got.done == data.size());
+      IoResult ended = reader_ring.ReadAll(fds[0], Span<const Span<std::byte>>(&whole, 1));
+      assert(ended.error == 0 && ended.done == 0);
+    });
+    IoResult ring_written = ring.WriteAll(fds[1], all);
+    assert(ring_written.error == 0 && ring_written.done == data.size());
+    ::close(fds[1]);
+    reader.join();
+    assert(piped == data);
+
+    // A closed descriptor reports its errno
+    Span<std::byte> rest(piped.data(), piped.size());
+    IoResult closed = ring.ReadAll(fds[1], Span<const Span<std::byte>>(&rest, 1));
+    assert(closed.error == EBADF && closed.done == 0);
+    ::close(fds[0]);
+  }
+
+  // Over a socket
+  {
+    int sockets[2];
+    assert(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+    Span<const Span<const std::byte>> head(fragments.data(), 16);
+    IoResult sent = ring.WriteAll(sockets[0], head);
+    assert(sent.error == 0 && sent.done == 16 * 4099);
+    std::vector<std::byte> got(16 * 4099);
+    Span<std::byte> whole(got.data(), got.size());
+    IoResult received_all = ring.ReadAll(sockets[1], Span<const Span<std::byte>>(&whole, 1));
+    assert(received_all.error == 0 && received_all.done == got.size());
+    assert(std::equal(got.begin(), got.end(), data.begin()));
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+  }
+}